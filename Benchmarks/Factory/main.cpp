@@ -0,0 +1,117 @@
+#include "SDIL.hpp"
+#include <chrono>
+#include <iostream>
+#include <utility>
+
+struct Logger
+{
+};
+
+template<>
+struct sdil::SDILTypeTraits<Logger>
+: SDILTypeTraitsBase,
+  sdil::Constructor<Logger>
+{
+    static constexpr sdil::LifeTimeScope LifeTime = LifeTimeScope::Singleton;
+};
+
+struct Config
+{
+};
+
+template<>
+struct sdil::SDILTypeTraits<Config>
+: SDILTypeTraitsBase,
+  sdil::Constructor<Config>
+{
+    static constexpr sdil::LifeTimeScope LifeTime = LifeTimeScope::Singleton;
+};
+
+/// Request made by factory, id is passed to create
+struct Request
+{
+    Request(std::shared_ptr<Logger> logger, Config& config, int id) : logger(std::move(logger)), config(config), id(id) { }
+
+    std::shared_ptr<Logger> logger;
+    Config& config;
+    int id;
+};
+
+template<>
+struct sdil::SDILTypeTraits<Request>
+: SDILTypeTraitsBase,
+  sdil::Constructor<Request, std::shared_ptr<Logger>, Config&, int>
+{
+    static constexpr sdil::LifeTimeScope LifeTime = LifeTimeScope::NotControlled;
+};
+
+/// Request made by resolve, id is set after it is resolved
+struct ResolvedRequest
+{
+    ResolvedRequest(std::shared_ptr<Logger> logger, Config& config) : logger(std::move(logger)), config(config) { }
+
+    std::shared_ptr<Logger> logger;
+    Config& config;
+    int id = 0;
+};
+
+template<>
+struct sdil::SDILTypeTraits<ResolvedRequest>
+: SDILTypeTraitsBase,
+  sdil::Constructor<ResolvedRequest, std::shared_ptr<Logger>, Config&>
+{
+    static constexpr sdil::LifeTimeScope LifeTime = LifeTimeScope::NotControlled;
+};
+
+/// Nanoseconds per call of function
+template<class Function>
+double Measure(size_t iterations, Function&& function)
+{
+    size_t sum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t index = 0; index < iterations; ++index)
+    {
+        sum += function(static_cast<int>(index));
+    }
+    auto time = std::chrono::steady_clock::now() - start;
+
+    if (sum == 0)
+    {
+        std::cout << "Nothing is created" << std::endl;
+    }
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(time).count()) / iterations;
+}
+
+int main(int argc, char* args[])
+{
+    constexpr size_t iterations = 1000000;
+
+    sdil::Container container;
+    container.Register<Logger>();
+    container.Register<Config>();
+    container.Register<Request>();
+    container.Register<ResolvedRequest>();
+
+    auto make_request = container.ResolveFactory<Request(int)>();
+    auto factory = [&make_request](int id)
+    {
+        return static_cast<size_t>(make_request(id)->id + 1);
+    };
+    auto resolve = [&container](int id)
+    {
+        auto request = container.Resolve<ResolvedRequest, sdil::UniquePtr>();
+        request->id = id;
+        return static_cast<size_t>(request->id + 1);
+    };
+
+    // Both are measured twice, so the second measurement is made with warm caches
+    for (int round = 0; round < 2; ++round)
+    {
+        const double factory_time = Measure(iterations, factory);
+        const double resolve_time = Measure(iterations, resolve);
+        std::cout << "Request with runtime id, factory: " << factory_time << "ns, "
+                  << "resolve and set: " << resolve_time << "ns" << std::endl;
+    }
+
+    return 0;
+}
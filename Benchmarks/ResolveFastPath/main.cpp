@@ -0,0 +1,59 @@
+#include "SDIL.hpp"
+#include <chrono>
+#include <iostream>
+
+struct Logger
+{
+};
+
+template<>
+struct sdil::SDILTypeTraits<Logger>
+: SDILTypeTraitsBase,
+  sdil::Constructor<Logger>
+{
+    static constexpr sdil::LifeTimeScope LifeTime = LifeTimeScope::Singleton;
+};
+
+/// Nanoseconds per resolution of built singleton as raw pointer
+double MeasurePointer(sdil::Container& container, size_t iterations)
+{
+    size_t sum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t index = 0; index < iterations; ++index)
+    {
+        sum += reinterpret_cast<size_t>(container.Resolve<Logger, sdil::Pointer>());
+    }
+    auto time = std::chrono::steady_clock::now() - start;
+
+    if (sum == 0)
+    {
+        std::cout << "Singleton is not resolved" << std::endl;
+    }
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(time).count()) / iterations;
+}
+
+int main(int argc, char* args[])
+{
+    constexpr size_t iterations = 10000000;
+
+    sdil::Container inline_path;
+    inline_path.Register<Logger>();
+    inline_path.Resolve<Logger>();
+
+    // The same request goes through out-of-line Resolve, and nothing else is enabled
+    sdil::Container out_of_line_path;
+    out_of_line_path.Register<Logger>();
+    out_of_line_path.Resolve<Logger>();
+    out_of_line_path.SetBuiltSingletonLookup(false);
+
+    // Both are measured twice, so the second measurement is made with warm caches
+    for (int round = 0; round < 2; ++round)
+    {
+        const double inline_time = MeasurePointer(inline_path, iterations);
+        const double out_of_line_time = MeasurePointer(out_of_line_path, iterations);
+        std::cout << "Resolve<Logger, Pointer> of built singleton, inline: " << inline_time << "ns, "
+                  << "out-of-line: " << out_of_line_time << "ns" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,126 @@
+#include "SDIL.hpp"
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <utility>
+
+template<int N>
+struct Leaf
+{
+};
+
+template<int N>
+struct sdil::SDILTypeTraits<Leaf<N>>
+: SDILTypeTraitsBase,
+  sdil::Constructor<Leaf<N>>
+{
+    static constexpr sdil::LifeTimeScope LifeTime = LifeTimeScope::NotControlled;
+};
+
+struct Branch
+{
+    Branch(std::unique_ptr<Leaf<1>> first, std::unique_ptr<Leaf<2>> second) : first(std::move(first)), second(std::move(second)) { }
+
+    std::unique_ptr<Leaf<1>> first;
+    std::unique_ptr<Leaf<2>> second;
+};
+
+template<>
+struct sdil::SDILTypeTraits<Branch>
+: SDILTypeTraitsBase,
+  sdil::Constructor<Branch, std::unique_ptr<Leaf<1>>, std::unique_ptr<Leaf<2>>>
+{
+    static constexpr sdil::LifeTimeScope LifeTime = LifeTimeScope::NotControlled;
+};
+
+/// Root of tree of five NotControlled types
+struct Root
+{
+    Root(std::unique_ptr<Branch> branch, std::unique_ptr<Leaf<3>> leaf) : branch(std::move(branch)), leaf(std::move(leaf)) { }
+
+    std::unique_ptr<Branch> branch;
+    std::unique_ptr<Leaf<3>> leaf;
+};
+
+template<>
+struct sdil::SDILTypeTraits<Root>
+: SDILTypeTraitsBase,
+  sdil::Constructor<Root, std::unique_ptr<Branch>, std::unique_ptr<Leaf<3>>>
+{
+    static constexpr sdil::LifeTimeScope LifeTime = LifeTimeScope::NotControlled;
+};
+
+struct Logger
+{
+};
+
+template<>
+struct sdil::SDILTypeTraits<Logger>
+: SDILTypeTraitsBase,
+  sdil::Constructor<Logger>
+{
+    static constexpr sdil::LifeTimeScope LifeTime = LifeTimeScope::Singleton;
+};
+
+/// Nanoseconds per call of function, the best of several runs
+template<class Function>
+double Measure(size_t iterations, Function&& function)
+{
+    double best = 0;
+    for (int run = 0; run < 200; ++run)
+    {
+        size_t sum = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t index = 0; index < iterations; ++index)
+        {
+            sum += function();
+        }
+        auto time = std::chrono::steady_clock::now() - start;
+
+        if (sum == 0)
+        {
+            std::cout << "Nothing is resolved" << std::endl;
+        }
+        const double run_time = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(time).count()) / iterations;
+        best = run == 0 ? run_time : std::min(best, run_time);
+    }
+    return best;
+}
+
+int main(int argc, char* args[])
+{
+    constexpr size_t iterations = 10000;
+
+    sdil::Container container;
+    container.Register<Leaf<1>>();
+    container.Register<Leaf<2>>();
+    container.Register<Leaf<3>>();
+    container.Register<Branch>();
+    container.Register<Root>();
+    container.Register<Logger>();
+    container.Resolve<Logger>();
+
+    const double tree_time = Measure(iterations, [&container]()
+    {
+        return static_cast<size_t>(container.Resolve<Root, sdil::UniquePtr>()->leaf != nullptr);
+    });
+    const double branch_time = Measure(iterations, [&container]()
+    {
+        return static_cast<size_t>(container.Resolve<Branch, sdil::UniquePtr>()->first != nullptr);
+    });
+    const double leaf_time = Measure(iterations, [&container]()
+    {
+        return static_cast<size_t>(container.Resolve<Leaf<1>, sdil::UniquePtr>() != nullptr);
+    });
+    const double singleton_time = Measure(iterations, [&container]()
+    {
+        return static_cast<size_t>(container.Resolve<Logger>() != nullptr);
+    });
+
+    std::cout << "Tree of five NotControlled types: " << tree_time << "ns" << std::endl;
+    std::cout << "NotControlled type with two dependencies: " << branch_time << "ns" << std::endl;
+    std::cout << "NotControlled type without dependencies: " << leaf_time << "ns" << std::endl;
+    std::cout << "Built singleton as SharedPtr: " << singleton_time << "ns" << std::endl;
+
+    return 0;
+}
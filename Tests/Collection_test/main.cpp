@@ -0,0 +1,104 @@
+#include "SDIL.hpp"
+#include <iostream>
+#include <utility>
+#include <set>
+
+struct Plugin
+{
+    virtual ~Plugin() = default;
+
+    virtual int Id() const = 0;
+};
+
+template<int N>
+struct PluginImpl : public Plugin
+{
+    int Id() const override { return N; }
+};
+
+template<int N>
+struct sdil::SDILTypeTraits<PluginImpl<N>> 
+: SDILTypeTraitsBase,
+  sdil::Constructor<PluginImpl<N>>
+{
+    static constexpr sdil::LifeTimeScope LifeTime = LifeTimeScope::Singleton;
+};
+
+struct Handler
+{
+    virtual ~Handler() = default;
+};
+
+struct Host
+{
+    explicit Host(std::vector<std::shared_ptr<Plugin>> plugins, std::vector<Handler*> handlers)
+    : plugins(std::move(plugins)), handlers(std::move(handlers))
+    {
+    }
+
+    std::vector<std::shared_ptr<Plugin>> plugins;
+    std::vector<Handler*> handlers;
+};
+
+template<>
+struct sdil::SDILTypeTraits<Host> 
+: SDILTypeTraitsBase,
+  sdil::Constructor<Host, std::vector<std::shared_ptr<Plugin>>, std::vector<Handler*>>
+{
+    static constexpr sdil::LifeTimeScope LifeTime = LifeTimeScope::Singleton;
+};
+
+int main(int argc, char* args[])
+{
+    sdil::Container container;
+    container.Register<PluginImpl<1>, Plugin>();
+    container.Register<PluginImpl<2>, Plugin>("second");
+    container.Register<PluginImpl<3>, Plugin>("third");
+
+    if (container.Register<PluginImpl<3>, Plugin>("third"))
+    {
+        return 1;
+    }
+
+    auto plugins = container.ResolveAll<Plugin>();
+    if (plugins.size() != 3)
+    {
+        std::cout << "Expected 3 plugins, resolved " << plugins.size() << std::endl;
+        return 1;
+    }
+
+    std::set<int> ids;
+    for (auto& plugin : plugins)
+    {
+        ids.insert(plugin->Id());
+    }
+    if (ids != std::set<int>{ 1, 2, 3 })
+    {
+        return 1;
+    }
+    std::cout << "All plugins are resolved" << std::endl;
+
+    auto raw_plugins = container.ResolveAll<Plugin, sdil::Pointer>();
+    for (size_t i = 0; i < plugins.size(); ++i)
+    {
+        if (raw_plugins[i] != plugins[i].get())
+        {
+            return 1;
+        }
+    }
+
+    if (!container.ResolveAll<Handler>().empty())
+    {
+        return 1;
+    }
+
+    container.Register<Host>();
+    auto host = container.Resolve<Host>();
+    if (host->plugins != plugins || !host->handlers.empty())
+    {
+        return 1;
+    }
+    std::cout << "Collection is injected into factory" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,168 @@
+#include "SDIL.hpp"
+#include <iostream>
+#include <string>
+#include <vector>
+
+struct Node
+{
+    virtual ~Node() = default;
+    virtual size_t Depth() const = 0;
+};
+
+struct Leaf : Node
+{
+    size_t Depth() const override { return 0; }
+};
+
+template<>
+struct sdil::SDILTypeTraits<Leaf>
+: SDILTypeTraitsBase,
+  sdil::Constructor<Leaf>
+{
+    static constexpr sdil::LifeTimeScope LifeTime = LifeTimeScope::Singleton;
+};
+
+struct Link : Node
+{
+    explicit Link(Node& next) : depth(next.Depth() + 1) { }
+
+    size_t Depth() const override { return depth; }
+
+    size_t depth;
+};
+
+template<>
+struct sdil::SDILTypeTraits<Link>
+: SDILTypeTraitsBase,
+  sdil::Constructor<Link, Node&>
+{
+    static constexpr sdil::LifeTimeScope LifeTime = LifeTimeScope::Singleton;
+};
+
+struct Wheel
+{
+    static int Count;
+
+    Wheel() { ++Count; }
+    ~Wheel() { --Count; }
+};
+
+int Wheel::Count = 0;
+
+template<>
+struct sdil::SDILTypeTraits<Wheel>
+: SDILTypeTraitsBase,
+  sdil::Constructor<Wheel>
+{
+    static constexpr sdil::LifeTimeScope LifeTime = LifeTimeScope::NotControlled;
+};
+
+struct Car;
+struct Engine
+{
+    explicit Engine(Car& car) { }
+};
+
+template<>
+struct sdil::SDILTypeTraits<Engine>
+: SDILTypeTraitsBase,
+  sdil::Constructor<Engine, Car&>
+{
+    static constexpr sdil::LifeTimeScope LifeTime = LifeTimeScope::Singleton;
+};
+
+struct Car
+{
+    Car(std::unique_ptr<Wheel> wheel, std::shared_ptr<Engine> engine) { }
+};
+
+template<>
+struct sdil::SDILTypeTraits<Car>
+: SDILTypeTraitsBase,
+  sdil::Constructor<Car, std::unique_ptr<Wheel>, std::shared_ptr<Engine>>
+{
+    static constexpr sdil::LifeTimeScope LifeTime = LifeTimeScope::Singleton;
+};
+
+struct Plugin
+{
+    virtual ~Plugin() = default;
+};
+
+struct PluginManager : Plugin
+{
+    explicit PluginManager(std::vector<std::shared_ptr<Plugin>> plugins) { }
+};
+
+template<>
+struct sdil::SDILTypeTraits<PluginManager>
+: SDILTypeTraitsBase,
+  sdil::Constructor<PluginManager, std::vector<std::shared_ptr<Plugin>>>
+{
+    static constexpr sdil::LifeTimeScope LifeTime = LifeTimeScope::Singleton;
+};
+
+int main(int argc, char* args[])
+{
+    // Deep enough to overflow stack of recursive resolution
+    constexpr size_t depth = 100000;
+
+    sdil::Container container;
+    container.Register<Leaf, Node>(std::to_string(depth));
+    for (size_t index = 0; index < depth; ++index)
+    {
+        container.Register<Link, Node>(std::to_string(index), { { sdil::GetTypeId<Node>(), std::to_string(index + 1) } });
+    }
+
+    if (container.Resolve<Node>("0")->Depth() != depth || container.Resolve<Node, sdil::Reference>("1").Depth() != depth - 1)
+    {
+        return 1;
+    }
+    std::cout << "Chain of " << depth << " dependencies is resolved" << std::endl;
+
+    container.Register<Wheel>();
+    container.Register<Engine>();
+    container.Register<Car>();
+    try
+    {
+        container.Resolve<Car>();
+        return 1;
+    }
+    catch (const sdil::SDILException& exception)
+    {
+        std::cout << exception.what() << std::endl;
+        if (std::string(exception.what()).find("Car -> Engine -> Car") == std::string::npos)
+        {
+            return 1;
+        }
+    }
+
+    if (Wheel::Count != 0)
+    {
+        std::cout << "Instances resolved before cycle is detected are not deleted" << std::endl;
+        return 1;
+    }
+
+    container.Register<PluginManager, Plugin>();
+    try
+    {
+        container.Resolve<Plugin>();
+        return 1;
+    }
+    catch (const sdil::SDILException& exception)
+    {
+        std::cout << exception.what() << std::endl;
+        if (std::string(exception.what()).find("Plugin -> Plugin") == std::string::npos)
+        {
+            return 1;
+        }
+    }
+
+    if (container.Resolve<Node>("2")->Depth() != depth - 2)
+    {
+        return 1;
+    }
+    std::cout << "Dependency cycles are reported" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,110 @@
+#include "SDIL.hpp"
+#include "SDIL_graph.hpp"
+#include <iostream>
+#include <thread>
+#include <utility>
+
+struct Audio
+{
+    virtual ~Audio() = default;
+};
+
+struct DirectXAudio : public Audio { };
+struct ALSAAudio : public Audio { };
+
+template<>
+struct sdil::SDILTypeTraits<DirectXAudio> : SDILTypeTraitsBase, sdil::Constructor<DirectXAudio>
+{
+    static constexpr sdil::LifeTimeScope LifeTime = LifeTimeScope::Singleton;
+};
+
+template<>
+struct sdil::SDILTypeTraits<ALSAAudio> : SDILTypeTraitsBase, sdil::Constructor<ALSAAudio>
+{
+    static constexpr sdil::LifeTimeScope LifeTime = LifeTimeScope::Singleton;
+};
+
+struct Engine
+{
+    Engine()
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+};
+
+template<>
+struct sdil::SDILTypeTraits<Engine> : SDILTypeTraitsBase, sdil::Constructor<Engine>
+{
+    static constexpr sdil::LifeTimeScope LifeTime = LifeTimeScope::Singleton;
+};
+
+struct Renderer
+{
+    Renderer(std::shared_ptr<Engine> engine, Audio& audio) { }
+};
+
+template<>
+struct sdil::SDILTypeTraits<Renderer> : SDILTypeTraitsBase, sdil::Constructor<Renderer, std::shared_ptr<Engine>, Audio&>
+{
+    static constexpr sdil::LifeTimeScope LifeTime = LifeTimeScope::Singleton;
+};
+
+struct Application
+{
+    Application(std::shared_ptr<Renderer> renderer, std::vector<Audio*> audio) { }
+};
+
+template<>
+struct sdil::SDILTypeTraits<Application> : SDILTypeTraitsBase, sdil::Constructor<Application, std::shared_ptr<Renderer>, std::vector<Audio*>>
+{
+    static constexpr sdil::LifeTimeScope LifeTime = LifeTimeScope::NotControlled;
+};
+
+int main(int argc, char* args[])
+{
+    sdil::Container container;
+    container.Register<DirectXAudio, Audio>();
+    container.Register<ALSAAudio, Audio>("alsa");
+    container.Register<Engine>();
+    container.Register<Renderer>("", { { sdil::GetTypeId<Audio>(), "alsa" } });
+    container.Register<Application>();
+
+    container.SetConstructionTiming(true);
+    container.Resolve<Application, sdil::UniquePtr>();
+
+    sdil::DependencyGraph graph = container.GetDependencyGraph();
+    graph.WriteDot(std::cout);
+    graph.WriteJson(std::cout);
+
+    if (graph.nodes.size() != 5 || graph.edges.size() != 5)
+    {
+        std::cout << "Unexpected graph size" << std::endl;
+        return 1;
+    }
+
+    for (const auto& edge : graph.edges)
+    {
+        const auto& from = graph.nodes[edge.from];
+        const auto& to = graph.nodes[edge.to];
+        if (from.interface_name == "Renderer" && to.interface_name == "Audio" && (!edge.overridden || to.type_name != "alsa"))
+        {
+            std::cout << "Override is not reflected in graph" << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<std::string_view> critical_path;
+    for (size_t node : graph.critical_path)
+    {
+        critical_path.push_back(graph.nodes[node].interface_name);
+    }
+
+    if (critical_path != std::vector<std::string_view>{ "Application", "Renderer", "Engine" }
+        || graph.critical_path_time < std::chrono::milliseconds(20))
+    {
+        std::cout << "Unexpected critical path" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
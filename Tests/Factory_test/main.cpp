@@ -0,0 +1,205 @@
+#include "SDIL.hpp"
+#include <iostream>
+#include <utility>
+
+struct Logger
+{
+    static int Count;
+
+    Logger() { ++Count; }
+};
+
+int Logger::Count = 0;
+
+template<>
+struct sdil::SDILTypeTraits<Logger>
+: SDILTypeTraitsBase,
+  sdil::Constructor<Logger>
+{
+    static constexpr sdil::LifeTimeScope LifeTime = LifeTimeScope::Singleton;
+};
+
+struct FileLogger : Logger
+{
+};
+
+template<>
+struct sdil::SDILTypeTraits<FileLogger>
+: SDILTypeTraitsBase,
+  sdil::Constructor<FileLogger>
+{
+    static constexpr sdil::LifeTimeScope LifeTime = LifeTimeScope::Singleton;
+};
+
+struct Request
+{
+    static int Count;
+
+    Request(std::shared_ptr<Logger> logger, Logger& logger_ref, int id, std::string& buffer)
+    : logger(std::move(logger)), id(id)
+    {
+        if (&logger_ref != this->logger.get())
+        {
+            exit(1);
+        }
+        ++Count;
+        buffer += std::to_string(id);
+    }
+
+    ~Request() { --Count; }
+
+    std::shared_ptr<Logger> logger;
+    int id;
+};
+
+int Request::Count = 0;
+
+template<>
+struct sdil::SDILTypeTraits<Request>
+: SDILTypeTraitsBase,
+  sdil::Constructor<Request, std::shared_ptr<Logger>, Logger&, int, std::string&>
+{
+    static constexpr sdil::LifeTimeScope LifeTime = LifeTimeScope::NotControlled;
+};
+
+struct Server
+{
+    explicit Server(sdil::Factory<Request(int, std::string&)> make_request)
+    : make_request(std::move(make_request))
+    {
+    }
+
+    sdil::Factory<Request(int, std::string&)> make_request;
+};
+
+template<>
+struct sdil::SDILTypeTraits<Server>
+: SDILTypeTraitsBase,
+  sdil::Constructor<Server, sdil::Factory<Request(int, std::string&)>>
+{
+    static constexpr sdil::LifeTimeScope LifeTime = LifeTimeScope::Singleton;
+};
+
+struct Helper
+{
+    static int Count;
+
+    Helper() { ++Count; }
+};
+
+int Helper::Count = 0;
+
+template<>
+struct sdil::SDILTypeTraits<Helper>
+: SDILTypeTraitsBase,
+  sdil::Constructor<Helper>
+{
+    static constexpr sdil::LifeTimeScope LifeTime = LifeTimeScope::NotControlled;
+};
+
+struct Task
+{
+    Task(Helper* helper, int id) : helper(helper), id(id) { }
+
+    std::unique_ptr<Helper> helper;
+    int id;
+};
+
+template<>
+struct sdil::SDILTypeTraits<Task>
+: SDILTypeTraitsBase,
+  sdil::Constructor<Task, Helper*, int>
+{
+    static constexpr sdil::LifeTimeScope LifeTime = LifeTimeScope::NotControlled;
+};
+
+struct Job
+{
+    Job(Logger* logger, int id) : logger(logger), id(id) { }
+
+    Logger* logger;
+    int id;
+};
+
+template<>
+struct sdil::SDILTypeTraits<Job>
+: SDILTypeTraitsBase,
+  sdil::Constructor<Job, Logger*, int>
+{
+    static constexpr sdil::LifeTimeScope LifeTime = LifeTimeScope::NotControlled;
+};
+
+int main(int argc, char* args[])
+{
+    sdil::Container container;
+    container.Register<Logger>();
+    container.Register<Request>();
+    container.Register<Server>();
+
+    std::string buffer;
+    auto make_request = container.ResolveFactory<Request(int, std::string&)>();
+    {
+        auto first = make_request(1, buffer);
+        auto second = make_request(2, buffer);
+
+        if (first.get() == second.get() || first->id != 1 || second->id != 2 || buffer != "12")
+        {
+            return 1;
+        }
+
+        if (first->logger != second->logger || Logger::Count != 1 || Request::Count != 2)
+        {
+            return 1;
+        }
+    }
+
+    if (Request::Count != 0)
+    {
+        std::cout << "Requests are not destroyed" << std::endl;
+        return 1;
+    }
+    std::cout << "Factory creates new instances with bound dependencies" << std::endl;
+
+    auto server = container.Resolve<Server>();
+    auto request = server->make_request(3, buffer);
+    if (request->logger != container.Resolve<Logger>() || buffer != "123")
+    {
+        return 1;
+    }
+    std::cout << "Factory is injected" << std::endl;
+
+    sdil::Container raw_container;
+    raw_container.Register<Logger>();
+    raw_container.Register<Helper>();
+    raw_container.Register<Task>();
+    raw_container.Register<Job>();
+    try
+    {
+        raw_container.ResolveFactory<Task(int)>();
+        std::cout << "NotControlled raw pointer is bound to factory" << std::endl;
+        return 1;
+    }
+    catch (const sdil::SDILException&)
+    {
+    }
+
+    if (Helper::Count != 0 || raw_container.ResolveFactory<Job(int)>()(1)->logger != raw_container.Resolve<Logger, sdil::Pointer>())
+    {
+        return 1;
+    }
+    std::cout << "NotControlled raw pointer is not bound to factory" << std::endl;
+
+    container.Register<FileLogger, Logger>("file");
+    try
+    {
+        container.ResolveFactory<Logger()>("file");
+        std::cout << "Factory ignores implementation registered with its name" << std::endl;
+        return 1;
+    }
+    catch (const sdil::SDILException& exception)
+    {
+        std::cout << exception.what() << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,173 @@
+#include "SDIL.hpp"
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+static size_t Allocations = 0;
+
+// Every replaceable form is replaced, so memory is always freed by the form matching its allocation
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    ++Allocations;
+    return std::malloc(size != 0 ? size : 1);
+}
+
+void* operator new(size_t size)
+{
+    if (void* memory = operator new(size, std::nothrow))
+    {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+    return operator new(size, std::nothrow);
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory, size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) noexcept
+{
+    std::free(memory);
+}
+
+struct Renderer
+{
+    virtual ~Renderer() = default;
+    virtual std::string Name() const = 0;
+};
+
+struct OpenGLRenderer : Renderer
+{
+    std::string Name() const override { return "OpenGL"; }
+};
+
+template<>
+struct sdil::SDILTypeTraits<OpenGLRenderer>
+: SDILTypeTraitsBase,
+  sdil::Constructor<OpenGLRenderer>
+{
+    static constexpr sdil::LifeTimeScope LifeTime = LifeTimeScope::Singleton;
+};
+
+struct VulkanRenderer : Renderer
+{
+    std::string Name() const override { return "Vulkan"; }
+};
+
+template<>
+struct sdil::SDILTypeTraits<VulkanRenderer>
+: SDILTypeTraitsBase,
+  sdil::Constructor<VulkanRenderer>
+{
+    static constexpr sdil::LifeTimeScope LifeTime = LifeTimeScope::Singleton;
+};
+
+struct Window
+{
+    explicit Window(std::shared_ptr<Renderer> renderer) : renderer(std::move(renderer)) { }
+
+    std::shared_ptr<Renderer> renderer;
+};
+
+template<>
+struct sdil::SDILTypeTraits<Window>
+: SDILTypeTraitsBase,
+  sdil::Constructor<Window, std::shared_ptr<Renderer>>
+{
+    static constexpr sdil::LifeTimeScope LifeTime = LifeTimeScope::NotControlled;
+};
+
+int main(int argc, char* args[])
+{
+    constexpr size_t count = 20000;
+
+    sdil::Container base;
+    base.Register<OpenGLRenderer, Renderer>();
+    base.Register<Window>();
+    std::vector<sdil::BatchRegistration> registrations;
+    for (size_t index = 0; index < count; ++index)
+    {
+        registrations.push_back(sdil::Container::MakeRegistration<Window>(std::to_string(index)));
+    }
+    base.RegisterBatch(registrations);
+    auto base_renderer = base.Resolve<Renderer>();
+
+    size_t allocations = Allocations;
+    sdil::Container untouched = base.Fork();
+    if (Allocations - allocations > 10)
+    {
+        std::cout << "Fork without changes copies registrations" << std::endl;
+        return 1;
+    }
+
+    // Change copies only chunk of the changed registration
+    sdil::Container fork = base.Fork();
+    allocations = Allocations;
+    if (!fork.Register<VulkanRenderer, Renderer>("vulkan") || Allocations - allocations > count / 10)
+    {
+        std::cout << "Change of fork copies registrations which are not changed" << std::endl;
+        return 1;
+    }
+    std::cout << "Fork shares registrations which are not changed" << std::endl;
+
+    if (!fork.Unregister<Renderer>() || !fork.Register<VulkanRenderer, Renderer>() || fork.Unregister<Renderer>("missing"))
+    {
+        return 1;
+    }
+
+    if (fork.Resolve<Window>()->renderer->Name() != "Vulkan" || fork.Resolve<Window>("42")->renderer->Name() != "Vulkan"
+        || base.Resolve<Window>()->renderer->Name() != "OpenGL" || base.Resolve<Renderer>() != base_renderer)
+    {
+        std::cout << "Changes of fork are visible in base container" << std::endl;
+        return 1;
+    }
+
+    if (!base.Register<OpenGLRenderer, Renderer>("opengl") || fork.ResolveAll<Renderer>().size() != 2 || base.ResolveAll<Renderer>().size() != 2
+        || untouched.ResolveAll<Renderer>().size() != 1)
+    {
+        std::cout << "Changes of base container are visible in fork" << std::endl;
+        return 1;
+    }
+
+    if (untouched.Resolve<Renderer>() == base_renderer || untouched.Resolve<Renderer>()->Name() != "OpenGL")
+    {
+        std::cout << "Instances are shared by forks" << std::endl;
+        return 1;
+    }
+    std::cout << "Fork does not share changes and instances" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,144 @@
+#include "SDIL.hpp"
+#include "SDIL_memory.hpp"
+#include <iostream>
+
+struct Cache : sdil::MemoryTracked
+{
+    char data[1024];
+};
+
+template<>
+struct sdil::SDILTypeTraits<Cache>
+: SDILTypeTraitsBase,
+  sdil::Constructor<Cache>
+{
+    static constexpr sdil::LifeTimeScope LifeTime = LifeTimeScope::ReferenceCounting;
+};
+
+struct Message
+{
+    virtual ~Message() = default;
+};
+
+struct TextMessage : Message, sdil::MemoryTracked
+{
+    explicit TextMessage(std::shared_ptr<Cache> cache) : cache(std::move(cache)) { }
+
+    std::shared_ptr<Cache> cache;
+    char text[100];
+};
+
+template<>
+struct sdil::SDILTypeTraits<TextMessage>
+: SDILTypeTraitsBase,
+  sdil::Constructor<TextMessage, std::shared_ptr<Cache>>
+{
+    static constexpr sdil::LifeTimeScope LifeTime = LifeTimeScope::NotControlled;
+};
+
+struct Packet : sdil::MemoryTracked
+{
+    explicit Packet(int size) : size(size) { }
+
+    int size;
+};
+
+template<>
+struct sdil::SDILTypeTraits<Packet>
+: SDILTypeTraitsBase,
+  sdil::Constructor<Packet, int>
+{
+    static constexpr sdil::LifeTimeScope LifeTime = LifeTimeScope::NotControlled;
+};
+
+struct Frame : sdil::MemoryTracked
+{
+    char pixels[256];
+};
+
+template<>
+struct sdil::SDILTypeTraits<Frame>
+: SDILTypeTraitsBase
+{
+    static constexpr sdil::LifeTimeScope LifeTime = LifeTimeScope::NotControlled;
+
+    static Frame* Create()
+    {
+        return new (std::nothrow) Frame();
+    }
+};
+
+int main(int argc, char* args[])
+{
+    sdil::Container container;
+    container.Register<Cache>();
+    container.Register<TextMessage, Message>("text");
+    container.Register<Packet>();
+
+    Message* raw = container.Resolve<Message, sdil::Pointer>("text");
+    {
+        auto unique = container.Resolve<Message, sdil::UniquePtr>("text");
+        sdil::MemoryStats messages = container.GetMemoryStats<Message>("text");
+        sdil::MemoryStats caches = container.GetMemoryStats<Cache>();
+        if (messages.live_instances != 2 || messages.live_bytes != 2 * sizeof(TextMessage) || caches.live_instances != 1 || caches.live_bytes != sizeof(Cache))
+        {
+            std::cout << "Live instances are not accounted" << std::endl;
+            return 1;
+        }
+    }
+
+    sdil::MemoryStats messages = container.GetMemoryStats<Message>("text");
+    if (messages.live_instances != 1 || messages.peak_bytes != 2 * sizeof(TextMessage) || messages.allocations != 2)
+    {
+        return 1;
+    }
+
+    delete raw;
+    messages = container.GetMemoryStats<Message>("text");
+    sdil::MemoryStats caches = container.GetMemoryStats<Cache>();
+    if (messages.live_instances != 0 || messages.live_bytes != 0 || caches.live_instances != 0 || caches.allocations != 1)
+    {
+        std::cout << "Instances released by caller are not accounted" << std::endl;
+        return 1;
+    }
+    std::cout << "Instances are accounted after they have left container" << std::endl;
+
+    auto make_packet = container.ResolveFactory<Packet(int)>();
+    {
+        auto packet = make_packet(42);
+        if (container.GetMemoryStats<Packet>().live_bytes != sizeof(Packet))
+        {
+            return 1;
+        }
+    }
+
+    // Allocations made outside of container are not accounted
+    delete new Packet(1);
+    sdil::MemoryStats packets = container.GetMemoryStats<Packet>();
+    if (packets.live_instances != 0 || packets.allocations != 1)
+    {
+        return 1;
+    }
+    std::cout << "Instances made by factory are accounted" << std::endl;
+
+    container.Register<Frame>();
+    {
+        auto frame = container.Resolve<Frame, sdil::UniquePtr>();
+        if (frame == nullptr || container.GetMemoryStats<Frame>().live_bytes != sizeof(Frame))
+        {
+            std::cout << "Instance allocated without exceptions is not accounted" << std::endl;
+            return 1;
+        }
+    }
+
+    alignas(Packet) unsigned char buffer[sizeof(Packet)];
+    Packet* placed = new (buffer) Packet(2);
+    placed->~Packet();
+    if (container.GetMemoryStats<Frame>().live_instances != 0 || container.GetMemoryStats<Packet>().allocations != 1)
+    {
+        return 1;
+    }
+    std::cout << "Placement and nothrow forms of new are available" << std::endl;
+
+    return 0;
+}
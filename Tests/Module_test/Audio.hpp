@@ -0,0 +1,9 @@
+#pragma once
+#include "SDIL.hpp"
+#include <string>
+
+struct Audio
+{
+    virtual ~Audio() = default;
+    virtual std::string Play() = 0;
+};
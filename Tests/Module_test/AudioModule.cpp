@@ -0,0 +1,33 @@
+#include "Audio.hpp"
+
+struct SpeakerAudio : Audio
+{
+    std::string Play() override { return "Speaker"; }
+};
+
+template<>
+struct sdil::SDILTypeTraits<SpeakerAudio>
+: SDILTypeTraitsBase,
+  sdil::Constructor<SpeakerAudio>
+{
+    static constexpr sdil::LifeTimeScope LifeTime = LifeTimeScope::Singleton;
+};
+
+struct QuietAudio : Audio
+{
+    std::string Play() override { return "Quiet"; }
+};
+
+template<>
+struct sdil::SDILTypeTraits<QuietAudio>
+: SDILTypeTraitsBase,
+  sdil::Constructor<QuietAudio>
+{
+    static constexpr sdil::LifeTimeScope LifeTime = LifeTimeScope::NotControlled;
+};
+
+SDIL_REGISTER_MODULE(container)
+{
+    container.Register<SpeakerAudio, Audio>();
+    container.Register<QuietAudio, Audio>("Quiet");
+}
@@ -0,0 +1,153 @@
+#include "Audio.hpp"
+#include <cstdio>
+#include <iostream>
+
+#if !defined(_WIN32)
+#include <dlfcn.h>
+#endif
+
+struct Player
+{
+    static int Count;
+
+    explicit Player(std::shared_ptr<Audio> audio)
+    : audio(std::move(audio))
+    {
+        ++Count;
+    }
+
+    std::shared_ptr<Audio> audio;
+};
+
+int Player::Count = 0;
+
+template<>
+struct sdil::SDILTypeTraits<Player>
+: SDILTypeTraitsBase,
+  sdil::Constructor<Player, std::shared_ptr<Audio>>
+{
+    static constexpr sdil::LifeTimeScope LifeTime = LifeTimeScope::Singleton;
+};
+
+/// Manifest of module which is registered in host without loading the module
+sdil::ModuleManifest GetAudioManifest()
+{
+    sdil::ModuleManifest manifest { AUDIO_MODULE_PATH };
+    manifest.Provides<Audio>().Provides<Audio>("Quiet");
+    return manifest;
+}
+
+struct Microphone
+{
+};
+
+bool IsModuleLoaded()
+{
+#if defined(_WIN32)
+    return true;
+#else
+    void* library = dlopen(AUDIO_MODULE_PATH, RTLD_NOW | RTLD_NOLOAD);
+    if (library != nullptr)
+    {
+        dlclose(library);
+    }
+    return library != nullptr;
+#endif
+}
+
+int main(int argc, char* args[])
+{
+    sdil::Container container;
+    container.Register<Player>();
+    if (!container.RegisterModule(GetAudioManifest()) || container.RegisterModule(GetAudioManifest()))
+    {
+        std::cout << "Module types are registered only once" << std::endl;
+        return 1;
+    }
+
+#if !defined(_WIN32)
+    if (IsModuleLoaded())
+    {
+        std::cout << "Module is loaded before first resolve" << std::endl;
+        return 1;
+    }
+#endif
+
+    auto player = container.Resolve<Player>();
+    if (player->audio->Play() != "Speaker" || !IsModuleLoaded())
+    {
+        return 1;
+    }
+    std::cout << "Module is loaded on first resolve" << std::endl;
+
+    if (container.Resolve<Audio>() != player->audio || container.Resolve<Audio>("Quiet")->Play() != "Quiet")
+    {
+        return 1;
+    }
+
+    auto audios = container.ResolveAll<Audio>();
+    if (audios.size() != 2)
+    {
+        return 1;
+    }
+    std::cout << "Module types are resolved by name and as collection" << std::endl;
+
+    sdil::Container missing_library;
+    missing_library.RegisterModule(sdil::ModuleManifest{ "missing_module_library" }.Provides<Audio>());
+    try
+    {
+        missing_library.Resolve<Audio>();
+        return 1;
+    }
+    catch (const sdil::SDILException& exception)
+    {
+        std::cout << exception.what() << std::endl;
+    }
+
+    sdil::Container missing_type;
+    missing_type.RegisterModule(GetAudioManifest().Provides<Microphone>());
+    try
+    {
+        missing_type.Resolve<Microphone>();
+        return 1;
+    }
+    catch (const sdil::SDILException& exception)
+    {
+        std::cout << exception.what() << std::endl;
+    }
+
+    if (missing_type.Resolve<Audio>("Quiet")->Play() != "Quiet")
+    {
+        return 1;
+    }
+    std::cout << "Missing module and type are reported" << std::endl;
+
+    const std::string profile = "module.sdilprofile";
+    {
+        sdil::Container recorded;
+        recorded.Register<Player>();
+        recorded.RegisterModule(GetAudioManifest());
+        recorded.StartProfileRecording();
+        recorded.Resolve<Player>();
+        if (!recorded.StopProfileRecording(profile))
+        {
+            return 1;
+        }
+    }
+
+    // Container replaying profile has placeholders where recorded one has types registered by module
+    sdil::Container replayed;
+    replayed.Register<Player>();
+    replayed.RegisterModule(GetAudioManifest());
+    const int players = Player::Count;
+    const bool is_replayed = replayed.ReplayProfile(profile);
+    std::remove(profile.c_str());
+    if (!is_replayed || Player::Count != players + 1 || replayed.Resolve<Player>()->audio->Play() != "Speaker" || Player::Count != players + 1)
+    {
+        std::cout << "Profile recorded with loaded module is not replayed" << std::endl;
+        return 1;
+    }
+    std::cout << "Profile recorded with loaded module is replayed" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,150 @@
+#include "SDIL.hpp"
+#include <iostream>
+
+struct Reader
+{
+    virtual ~Reader() = default;
+    virtual int Read() = 0;
+};
+
+struct Writer
+{
+    virtual ~Writer() = default;
+    virtual void Write(int value) = 0;
+};
+
+struct Buffer : Reader, Writer
+{
+    static int Count;
+
+    Buffer() { ++Count; }
+    ~Buffer() override { --Count; }
+
+    int Read() override { return value; }
+    void Write(int value) override { this->value = value; }
+
+    int value = 0;
+};
+
+int Buffer::Count = 0;
+
+template<>
+struct sdil::SDILTypeTraits<Buffer>
+: SDILTypeTraitsBase,
+  sdil::Constructor<Buffer>
+{
+    static constexpr sdil::LifeTimeScope LifeTime = LifeTimeScope::Singleton;
+};
+
+struct Channel : Reader, Writer
+{
+    static int Count;
+
+    Channel() { ++Count; }
+    ~Channel() override { --Count; }
+
+    int Read() override { return value; }
+    void Write(int value) override { this->value = value; }
+
+    int value = 0;
+};
+
+int Channel::Count = 0;
+
+template<>
+struct sdil::SDILTypeTraits<Channel>
+: SDILTypeTraitsBase,
+  sdil::Constructor<Channel>
+{
+    static constexpr sdil::LifeTimeScope LifeTime = LifeTimeScope::ReferenceCounting;
+};
+
+struct Pipe
+{
+    Pipe(Writer& writer, std::shared_ptr<Reader> reader)
+    : writer(writer), reader(std::move(reader))
+    {
+    }
+
+    Writer& writer;
+    std::shared_ptr<Reader> reader;
+};
+
+template<>
+struct sdil::SDILTypeTraits<Pipe>
+: SDILTypeTraitsBase,
+  sdil::Constructor<Pipe, Writer&, std::shared_ptr<Reader>>
+{
+    static constexpr sdil::LifeTimeScope LifeTime = LifeTimeScope::NotControlled;
+};
+
+int main(int argc, char* args[])
+{
+    {
+        sdil::Container container;
+        if (!container.Register<Buffer, Reader, Writer, Buffer>() || container.Register<Buffer, Writer>())
+        {
+            std::cout << "Interfaces are registered only once" << std::endl;
+            return 1;
+        }
+        container.Register<Pipe>();
+
+        // Alias is resolved before the interface it is registered with
+        Writer& writer = container.Resolve<Writer, sdil::Reference>();
+        auto reader = container.Resolve<Reader>();
+        auto pipe = container.Resolve<Pipe, sdil::UniquePtr>();
+        if (Buffer::Count != 1 || &pipe->writer != &writer || pipe->reader != reader)
+        {
+            return 1;
+        }
+
+        writer.Write(42);
+        if (reader->Read() != 42 || container.Resolve<Buffer, sdil::Pointer>() != static_cast<Buffer*>(reader.get()))
+        {
+            return 1;
+        }
+    }
+
+    if (Buffer::Count != 0)
+    {
+        std::cout << "Singleton is not deleted" << std::endl;
+        return 1;
+    }
+    std::cout << "Singleton is shared by interfaces" << std::endl;
+
+    sdil::Container container;
+    container.Register<Channel, Reader, Writer>("channel");
+    {
+        auto writer = container.Resolve<Writer>("channel");
+        auto reader = container.Resolve<Reader>("channel");
+        writer->Write(7);
+        if (Channel::Count != 1 || reader->Read() != 7)
+        {
+            return 1;
+        }
+    }
+
+    if (Channel::Count != 0)
+    {
+        std::cout << "Reference counting instance is not deleted" << std::endl;
+        return 1;
+    }
+
+    auto writer = container.Resolve<Writer>("channel");
+    auto reader = container.Resolve<Reader>("channel");
+    if (Channel::Count != 1 || static_cast<Channel*>(writer.get()) != static_cast<Channel*>(reader.get()))
+    {
+        return 1;
+    }
+    std::cout << "Reference counting instance is shared by interfaces" << std::endl;
+
+    sdil::Container partial;
+    partial.Register<Channel, Writer>();
+    if (partial.Register<Buffer, Reader, Writer>() || partial.ResolveAll<Reader>().size() != 0 || !partial.Register<Buffer, Reader>())
+    {
+        std::cout << "Interfaces are registered partially" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
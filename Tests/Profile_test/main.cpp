@@ -0,0 +1,273 @@
+#include "SDIL.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <utility>
+
+template<int N>
+struct Service
+{
+    static std::atomic<int> Count;
+
+    Service()
+    {
+        ++Count;
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+};
+
+template<int N>
+std::atomic<int> Service<N>::Count = 0;
+
+template<int N>
+struct sdil::SDILTypeTraits<Service<N>>
+: SDILTypeTraitsBase,
+  sdil::Constructor<Service<N>>
+{
+    static constexpr sdil::LifeTimeScope LifeTime = LifeTimeScope::Singleton;
+};
+
+struct Application
+{
+    static std::atomic<int> Count;
+
+    Application(std::shared_ptr<Service<1>>, Service<2>&, Service<3>*)
+    {
+        ++Count;
+    }
+};
+
+std::atomic<int> Application::Count = 0;
+
+template<>
+struct sdil::SDILTypeTraits<Application>
+: SDILTypeTraitsBase,
+  sdil::Constructor<Application, std::shared_ptr<Service<1>>, Service<2>&, Service<3>*>
+{
+    static constexpr sdil::LifeTimeScope LifeTime = LifeTimeScope::Singleton;
+};
+
+void Configure(sdil::Container& container)
+{
+    container.Register<Service<1>>();
+    container.Register<Service<2>>();
+    container.Register<Service<3>>();
+    container.Register<Application>();
+}
+
+int GetConstructionsCount()
+{
+    return Service<1>::Count + Service<2>::Count + Service<3>::Count + Application::Count;
+}
+
+struct Clock
+{
+    static std::atomic<int> Count;
+
+    Clock()
+    {
+        ++Count;
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+};
+
+std::atomic<int> Clock::Count = 0;
+
+template<>
+struct sdil::SDILTypeTraits<Clock>
+: SDILTypeTraitsBase,
+  sdil::Constructor<Clock>
+{
+    static constexpr sdil::LifeTimeScope LifeTime = LifeTimeScope::Singleton;
+};
+
+struct Timer
+{
+    explicit Timer(std::shared_ptr<Clock> clock) : clock(std::move(clock)) { }
+
+    std::shared_ptr<Clock> clock;
+};
+
+template<>
+struct sdil::SDILTypeTraits<Timer>
+: SDILTypeTraitsBase,
+  sdil::Constructor<Timer, std::shared_ptr<Clock>>
+{
+    static constexpr sdil::LifeTimeScope LifeTime = LifeTimeScope::ReferenceCounting;
+};
+
+struct Scheduler
+{
+    explicit Scheduler(std::shared_ptr<Timer> timer) : timer(std::move(timer)) { }
+
+    std::shared_ptr<Timer> timer;
+};
+
+template<>
+struct sdil::SDILTypeTraits<Scheduler>
+: SDILTypeTraitsBase,
+  sdil::Constructor<Scheduler, std::shared_ptr<Timer>>
+{
+    static constexpr sdil::LifeTimeScope LifeTime = LifeTimeScope::Singleton;
+};
+
+/// Removes profiles written by test when it ends
+struct ProfileFiles
+{
+    ~ProfileFiles()
+    {
+        for (const char* path : { "startup.sdilprofile", "overrides.sdilprofile", "unrecorded.sdilprofile" })
+        {
+            std::remove(path);
+        }
+    }
+};
+
+int main(int argc, char* args[])
+{
+    const ProfileFiles profile_files;
+    const std::string profile = "startup.sdilprofile";
+
+    {
+        sdil::Container container;
+        Configure(container);
+        container.StartProfileRecording();
+        container.Resolve<Application>();
+        if (!container.StopProfileRecording(profile))
+        {
+            std::cout << "Profile is not saved" << std::endl;
+            return 1;
+        }
+    }
+
+    if (GetConstructionsCount() != 4)
+    {
+        return 1;
+    }
+
+    {
+        sdil::Container container;
+        Configure(container);
+
+        auto start = std::chrono::steady_clock::now();
+        if (!container.ReplayProfile(profile, 3))
+        {
+            std::cout << "Profile is not replayed" << std::endl;
+            return 1;
+        }
+        auto replay_time = std::chrono::steady_clock::now() - start;
+        std::cout << "Replay took " << std::chrono::duration_cast<std::chrono::milliseconds>(replay_time).count() << "ms" << std::endl;
+
+        if (GetConstructionsCount() != 8)
+        {
+            std::cout << "Singletons are not constructed by replay" << std::endl;
+            return 1;
+        }
+
+        container.Resolve<Application>();
+        container.Resolve<Service<2>, sdil::Reference>();
+        if (GetConstructionsCount() != 8)
+        {
+            std::cout << "Singletons are constructed twice" << std::endl;
+            return 1;
+        }
+    }
+
+    {
+        sdil::Container container;
+        Configure(container);
+        container.Register<Service<4>>();
+
+        if (container.ReplayProfile(profile, 3) || GetConstructionsCount() != 8)
+        {
+            std::cout << "Profile of changed registry is not ignored" << std::endl;
+            return 1;
+        }
+    }
+
+    {
+        std::ifstream file(profile, std::ios::binary);
+        std::string data { std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+        file.close();
+
+        std::ofstream truncated(profile, std::ios::binary | std::ios::trunc);
+        truncated.write(data.data(), data.size() - 1);
+        truncated.close();
+
+        sdil::Container container;
+        Configure(container);
+        if (container.ReplayProfile(profile, 3) || container.ReplayProfile("missing.sdilprofile") || GetConstructionsCount() != 8)
+        {
+            std::cout << "Corrupted profile is not ignored" << std::endl;
+            return 1;
+        }
+    }
+
+    {
+        sdil::Container container;
+        Configure(container);
+        container.Register<Service<1>>("first");
+        container.Register<Application>("first", { { sdil::GetTypeId<Service<1>>(), "first" } });
+        container.StartProfileRecording();
+        container.Resolve<Application>("first");
+        container.StopProfileRecording("overrides.sdilprofile");
+    }
+
+    {
+        sdil::Container container;
+        Configure(container);
+        container.Register<Service<1>>("first");
+        container.Register<Application>("first", { { sdil::GetTypeId<Service<1>>(), "" } });
+        if (container.ReplayProfile("overrides.sdilprofile", 3))
+        {
+            std::cout << "Profile of changed overrides is not ignored" << std::endl;
+            return 1;
+        }
+    }
+
+    {
+        // Timer is alive while Scheduler is recorded, so dependency of Scheduler on Clock is not recorded
+        // and both are replayed concurrently
+        sdil::Container container;
+        container.Register<Clock>();
+        container.Register<Timer>();
+        container.Register<Scheduler>();
+        container.StartProfileRecording();
+        auto timer = container.Resolve<Timer>();
+        container.Resolve<Scheduler>();
+        container.StopProfileRecording("unrecorded.sdilprofile");
+    }
+
+    for (int run = 0; run < 5; ++run)
+    {
+        Clock::Count = 0;
+        sdil::Container container;
+        container.Register<Clock>();
+        container.Register<Timer>();
+        container.Register<Scheduler>();
+        if (!container.ReplayProfile("unrecorded.sdilprofile", 2) || Clock::Count != 1
+            || container.Resolve<Scheduler>()->timer->clock != container.Resolve<Clock>() || Clock::Count != 1)
+        {
+            std::cout << "Singleton is constructed twice by replay" << std::endl;
+            return 1;
+        }
+    }
+
+    {
+        sdil::Container container;
+        Configure(container);
+        container.StartProfileRecording();
+        sdil::Container copy = container;
+        copy.Resolve<Application>();
+        if (container.StopProfileRecording(profile) || !copy.StopProfileRecording(profile))
+        {
+            std::cout << "Copy of container does not record its own profile" << std::endl;
+            return 1;
+        }
+    }
+
+    return 0;
+}
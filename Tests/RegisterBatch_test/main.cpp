@@ -0,0 +1,123 @@
+#include "SDIL.hpp"
+#include <iostream>
+#include <string>
+#include <vector>
+
+struct Storage
+{
+    virtual ~Storage() = default;
+    virtual std::string Name() const = 0;
+};
+
+struct DiskStorage : Storage
+{
+    std::string Name() const override { return "disk"; }
+};
+
+template<>
+struct sdil::SDILTypeTraits<DiskStorage>
+: SDILTypeTraitsBase,
+  sdil::Constructor<DiskStorage>
+{
+    static constexpr sdil::LifeTimeScope LifeTime = LifeTimeScope::Singleton;
+};
+
+struct MemoryStorage : Storage
+{
+    std::string Name() const override { return "memory"; }
+};
+
+template<>
+struct sdil::SDILTypeTraits<MemoryStorage>
+: SDILTypeTraitsBase,
+  sdil::Constructor<MemoryStorage>
+{
+    static constexpr sdil::LifeTimeScope LifeTime = LifeTimeScope::Singleton;
+};
+
+struct Cache
+{
+    explicit Cache(std::shared_ptr<Storage> storage) : storage(std::move(storage)) { }
+
+    std::shared_ptr<Storage> storage;
+};
+
+template<>
+struct sdil::SDILTypeTraits<Cache>
+: SDILTypeTraitsBase,
+  sdil::Constructor<Cache, std::shared_ptr<Storage>>
+{
+    static constexpr sdil::LifeTimeScope LifeTime = LifeTimeScope::NotControlled;
+};
+
+int main(int argc, char* args[])
+{
+    using sdil::Container;
+    const sdil::BatchRegistration registrations[] = {
+        Container::MakeRegistration<MemoryStorage, Storage>("memory"),
+        Container::MakeRegistration<DiskStorage, Storage>(),
+        Container::MakeRegistration<Cache>("", Container::MakeOverrides({ { sdil::GetTypeId<Storage>(), "memory" } })),
+        Container::MakeRegistration<DiskStorage, Storage>("memory"),
+        Container::MakeRegistration<Cache>("disk"),
+    };
+
+    Container container;
+    container.Register<DiskStorage, Storage>("disk");
+    const std::vector<size_t> rejected = container.RegisterBatch(registrations);
+    if (rejected != std::vector<size_t>{ 3 } || container.RegisterBatch(registrations).size() != std::size(registrations))
+    {
+        std::cout << "Duplicates are not reported" << std::endl;
+        return 1;
+    }
+
+    if (container.Resolve<Cache>()->storage->Name() != "memory" || container.Resolve<Cache>("disk")->storage->Name() != "disk")
+    {
+        return 1;
+    }
+
+    auto storages = container.ResolveAll<Storage>();
+    if (storages.size() != 3 || storages[0]->Name() != "disk" || storages[1]->Name() != "memory" || storages[2]->Name() != "disk"
+        || storages[0] == storages[2])
+    {
+        std::cout << "Collection is not in order of registration" << std::endl;
+        return 1;
+    }
+    std::cout << "Table is registered" << std::endl;
+
+    const auto overrides = Container::MakeOverrides({ { sdil::GetTypeId<Storage>(), "memory" } });
+    std::vector<sdil::BatchRegistration> table;
+    for (size_t index = 0; index < 100; ++index)
+    {
+        table.push_back(Container::MakeRegistration<Cache>(std::to_string(index), overrides));
+    }
+
+    Container batch;
+    batch.Register<Cache>("single", *overrides);
+    if (!batch.RegisterBatch(table).empty() || batch.RegisterBatch(table).size() != table.size())
+    {
+        return 1;
+    }
+
+    // GetOverride views name stored in overrides of registration, so registrations sharing overrides give the same view
+    const char* shared = batch.GetOverride<Storage>(sdil::internal::TypeKey{ sdil::GetTypeId<Cache>(), "single" }).data();
+    for (size_t index = 0; index < table.size(); ++index)
+    {
+        if (batch.GetOverride<Storage>(sdil::internal::TypeKey{ sdil::GetTypeId<Cache>(), std::to_string(index) }).data() != shared)
+        {
+            std::cout << "Equal overrides are not shared" << std::endl;
+            return 1;
+        }
+    }
+    std::cout << "Equal overrides are shared" << std::endl;
+
+    // Overrides made by MakeOverrides are stored by container without copy
+    Container fresh;
+    fresh.RegisterBatch(table);
+    if (fresh.GetOverride<Storage>(sdil::internal::TypeKey{ sdil::GetTypeId<Cache>(), "0" }).data() != overrides->at(sdil::GetTypeId<Storage>()).data())
+    {
+        std::cout << "Overrides are copied" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
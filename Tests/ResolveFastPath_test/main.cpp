@@ -0,0 +1,88 @@
+#include "SDIL.hpp"
+#include "SDIL_tracing.hpp"
+#include <iostream>
+#include <sstream>
+
+struct Logger
+{
+    static int Count;
+
+    Logger() { ++Count; }
+};
+
+int Logger::Count = 0;
+
+template<>
+struct sdil::SDILTypeTraits<Logger>
+: SDILTypeTraitsBase,
+  sdil::Constructor<Logger>
+{
+    static constexpr sdil::LifeTimeScope LifeTime = LifeTimeScope::Singleton;
+};
+
+struct Request
+{
+    explicit Request(Logger& logger) : logger(logger) { }
+
+    Logger& logger;
+};
+
+template<>
+struct sdil::SDILTypeTraits<Request>
+: SDILTypeTraitsBase,
+  sdil::Constructor<Request, Logger&>
+{
+    static constexpr sdil::LifeTimeScope LifeTime = LifeTimeScope::NotControlled;
+};
+
+int main(int argc, char* args[])
+{
+    sdil::Container container;
+    container.Register<Logger>();
+    container.Register<Logger>("Named");
+    container.Register<Request>();
+
+    // First resolution builds singleton, next ones find it
+    Logger* logger = container.Resolve<Logger, sdil::Pointer>();
+    if (logger == nullptr || &container.Resolve<Logger, sdil::Reference>() != logger || container.Resolve<Logger>().get() != logger
+        || container.Resolve<Logger, sdil::Pointer>("Named") == logger || Logger::Count != 2)
+    {
+        return 1;
+    }
+
+    auto request = container.Resolve<Request>();
+    if (&request->logger != logger || container.Resolve<Logger>().use_count() != 2)
+    {
+        std::cout << "Reference counter is changed by Pointer or Reference" << std::endl;
+        return 1;
+    }
+    std::cout << "Built singleton is resolved as pointer and reference" << std::endl;
+
+    auto tracer = std::make_shared<sdil::Tracer>();
+    container.SetTracer(tracer);
+    if (container.Resolve<Logger, sdil::Pointer>() != logger)
+    {
+        return 1;
+    }
+    std::ostringstream trace;
+    tracer->WriteChromeTrace(trace);
+    if (trace.str().find("Logger") == std::string::npos)
+    {
+        std::cout << "Traced resolution is not recorded" << std::endl;
+        return 1;
+    }
+    std::cout << "Traced resolution takes full path" << std::endl;
+
+    sdil::Container untraced;
+    untraced.Register<Logger>();
+    Logger* built = untraced.Resolve<Logger, sdil::Pointer>();
+    untraced.SetBuiltSingletonLookup(false);
+    if (untraced.Resolve<Logger, sdil::Pointer>() != built || &untraced.Resolve<Logger, sdil::Reference>() != built || Logger::Count != 3)
+    {
+        std::cout << "Full path does not find built singleton" << std::endl;
+        return 1;
+    }
+    std::cout << "Built singleton lookup can be disabled" << std::endl;
+
+    return 0;
+}
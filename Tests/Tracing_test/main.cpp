@@ -0,0 +1,88 @@
+#include "SDIL.hpp"
+#include "SDIL_tracing.hpp"
+#include <iostream>
+#include <sstream>
+#include <utility>
+
+struct Audio
+{
+    virtual ~Audio() = default;
+};
+
+struct ALSAAudio : public Audio { };
+
+template<>
+struct sdil::SDILTypeTraits<ALSAAudio>
+: SDILTypeTraitsBase,
+  sdil::Constructor<ALSAAudio>
+{
+    static constexpr sdil::LifeTimeScope LifeTime = LifeTimeScope::ReferenceCounting;
+};
+
+struct Button
+{
+    explicit Button(std::shared_ptr<Audio> audio) : audio(std::move(audio)) { }
+
+    std::shared_ptr<Audio> audio;
+};
+
+template<>
+struct sdil::SDILTypeTraits<Button>
+: SDILTypeTraitsBase,
+  sdil::Constructor<Button, std::shared_ptr<Audio>>
+{
+    static constexpr sdil::LifeTimeScope LifeTime = LifeTimeScope::NotControlled;
+};
+
+size_t CountOccurrences(const std::string& text, const std::string& pattern)
+{
+    size_t count = 0;
+    for (size_t position = text.find(pattern); position != std::string::npos; position = text.find(pattern, position + 1))
+    {
+        ++count;
+    }
+    return count;
+}
+
+int main(int argc, char* args[])
+{
+    auto tracer = std::make_shared<sdil::Tracer>();
+
+    sdil::Container container;
+    container.Register<ALSAAudio, Audio>("alsa");
+    container.Register<Button>("", { { sdil::GetTypeId<Audio>(), "alsa" } });
+    container.SetTracer(tracer);
+
+    container.Resolve<Button>();
+    {
+        auto make_button = container.ResolveFactory<Button()>();
+        make_button();
+    }
+
+    container.SetTracer(nullptr);
+    container.Resolve<Button, sdil::UniquePtr>();
+
+    std::stringstream trace;
+    tracer->WriteChromeTrace(trace);
+    const std::string json = trace.str();
+    std::cout << json;
+
+    // Button and Audio are resolved, created and deleted once by container and once by factory
+    if (CountOccurrences(json, "\"cat\":\"resolve\"") != 3
+        || CountOccurrences(json, "\"cat\":\"create\"") != 4
+        || CountOccurrences(json, "\"cat\":\"delete\"") != 4)
+    {
+        std::cout << "Unexpected number of spans" << std::endl;
+        return 1;
+    }
+
+    if (json.find("\"name\":\"Audio[alsa]\"") == std::string::npos
+        || json.find("\"lifetime\":\"ReferenceCounting\"") == std::string::npos
+        || json.find("\"name\":\"Button\"") == std::string::npos)
+    {
+        std::cout << "Spans do not describe type keys" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
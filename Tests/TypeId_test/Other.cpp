@@ -0,0 +1,32 @@
+#include "SDIL.hpp"
+
+namespace
+{
+    struct Config
+    {
+        int value = 42;
+    };
+}
+
+template<>
+struct sdil::SDILTypeTraits<Config>
+: SDILTypeTraitsBase,
+  sdil::Constructor<Config>
+{
+    static constexpr sdil::LifeTimeScope LifeTime = LifeTimeScope::Singleton;
+};
+
+bool RegisterOtherConfig(sdil::Container& container)
+{
+    return container.Register<Config>();
+}
+
+int ResolveOtherConfig(sdil::Container& container)
+{
+    return container.Resolve<Config>()->value;
+}
+
+sdil::TypeId GetOtherConfigId()
+{
+    return sdil::GetTypeId<Config>();
+}
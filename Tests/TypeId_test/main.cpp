@@ -0,0 +1,58 @@
+#include "SDIL.hpp"
+#include <iostream>
+#include <string>
+
+namespace
+{
+    struct Config
+    {
+        std::string text = "main";
+    };
+}
+
+template<>
+struct sdil::SDILTypeTraits<Config>
+: SDILTypeTraitsBase,
+  sdil::Constructor<Config>
+{
+    static constexpr sdil::LifeTimeScope LifeTime = LifeTimeScope::Singleton;
+};
+
+struct Settings
+{
+};
+
+bool RegisterOtherConfig(sdil::Container& container);
+int ResolveOtherConfig(sdil::Container& container);
+sdil::TypeId GetOtherConfigId();
+
+int main(int argc, char* args[])
+{
+    if (sdil::GetTypeId<Config>() == GetOtherConfigId() || sdil::GetTypeId<Config>() != sdil::GetTypeId<Config>())
+    {
+        std::cout << "Types of anonymous namespaces share identifier" << std::endl;
+        return 1;
+    }
+
+    if (sdil::GetTypeId<Settings>() != sdil::internal::Hash(sdil::GetTypeName<Settings>()))
+    {
+        std::cout << "Identifier of type with linkage is not computed from its name" << std::endl;
+        return 1;
+    }
+
+    sdil::Container container;
+    if (!container.Register<Config>() || !RegisterOtherConfig(container))
+    {
+        std::cout << "Type of another anonymous namespace is rejected" << std::endl;
+        return 1;
+    }
+
+    if (container.Resolve<Config>()->text != "main" || ResolveOtherConfig(container) != 42)
+    {
+        std::cout << "Instance of another type with the same name is resolved" << std::endl;
+        return 1;
+    }
+    std::cout << "Types with the same name are distinct" << std::endl;
+
+    return 0;
+}
@@ -1,19 +1,62 @@
 #ifndef SDIL_SDIL_HPP
 #define SDIL_SDIL_HPP
 
+#include <cstddef>
 #include <string_view>
 #include <functional>
-#include <variant>
 #include <stdexcept>
 
 #include "SDIL_internal.hpp"
 
+#if defined(_WIN32)
+#define SDIL_MODULE_EXPORT extern "C" __declspec(dllexport)
+#else
+#define SDIL_MODULE_EXPORT extern "C" __attribute__((visibility("default")))
+#endif
+
+/// Defines function which registers types of module, e.g. SDIL_REGISTER_MODULE(container) { container.Register<...>(); }
+#define SDIL_REGISTER_MODULE(container) SDIL_MODULE_EXPORT void SDILRegisterModule(sdil::Container& container)
+
 namespace sdil
 {
+    /// Human readable name of Type, as it is spelled by compiler
+    template<class Type>
+    constexpr std::string_view GetTypeName()
+    {
+#if defined(_MSC_VER)
+        constexpr std::string_view function = __FUNCSIG__;
+        constexpr std::string_view prefix = "GetTypeName<";
+        constexpr std::string_view suffix = ">(void)";
+        constexpr size_t begin = function.find(prefix) + prefix.size();
+        constexpr size_t end = function.rfind(suffix);
+#elif defined(__clang__)
+        constexpr std::string_view function = __PRETTY_FUNCTION__;
+        constexpr std::string_view prefix = "Type = ";
+        constexpr size_t begin = function.find(prefix) + prefix.size();
+        constexpr size_t end = function.rfind(']');
+#else
+        constexpr std::string_view function = __PRETTY_FUNCTION__;
+        constexpr std::string_view prefix = "Type = ";
+        constexpr size_t begin = function.find(prefix) + prefix.size();
+        constexpr size_t end = function.find(';', begin);
+#endif
+        return function.substr(begin, end - begin);
+    }
+
+    /// Identifier of Type computed from its name, so it stays the same between runs and shared libraries.
+    /// Type declared in anonymous namespace or in function can share name with another type, so it is identified by address
     template<class Type>
     inline TypeId GetTypeId()
     {
-        return reinterpret_cast<TypeId>(&GetTypeId<Type>);
+        if constexpr (internal::IsLocalTypeName(GetTypeName<Type>()))
+        {
+            return reinterpret_cast<TypeId>(&GetTypeId<Type>);
+        }
+        else
+        {
+            constexpr TypeId type_id = static_cast<TypeId>(internal::Hash(GetTypeName<Type>()));
+            return type_id;
+        }
     }
 
     template<class Type>
@@ -34,34 +77,175 @@ namespace sdil
         using logic_error::logic_error;
     };
 
+    /// Memory of MemoryTracked instances created by registration, see SDIL_memory.hpp
+    struct MemoryStats
+    {
+        size_t live_instances = 0;
+        size_t live_bytes = 0;
+        /// The most bytes which have been live at once
+        size_t peak_bytes = 0;
+        size_t allocations = 0;
+    };
+
+    /// Describes shared library which registers types in container with SDIL_REGISTER_MODULE function
+    struct ModuleManifest
+    {
+        std::string library_path;
+        std::vector<internal::ModuleType> types;
+
+        /// Declares that module registers implementation of Interface with given name
+        template<class Interface>
+        ModuleManifest& Provides(std::string_view name = "")
+        {
+            types.push_back({ GetTypeId<Interface>(), GetTypeName<Interface>(), static_cast<std::string>(name) });
+            return *this;
+        }
+    };
+
+    /// Registration made by Container::MakeRegistration to be added with Container::RegisterBatch
+    class BatchRegistration
+    {
+    private:
+        friend class Container;
+
+        BatchRegistration(internal::TypeKey type_key, internal::TypeRecord type_record, std::shared_ptr<const Overrides> overrides)
+        : type_key(std::move(type_key)), type_record(std::move(type_record)), overrides(std::move(overrides))
+        {
+        }
+
+        internal::TypeKey type_key;
+        internal::TypeRecord type_record;
+        /// Not set if type has no overrides
+        std::shared_ptr<const Overrides> overrides;
+    };
+
     class Container
     {
     public:
-        template<class Type, class Interface = Type>
+        Container() = default;
+
+        /// Copies registrations, instances and profile recorded so far. State of profile replay is not copied
+        Container(const Container& other);
+        Container& operator=(const Container& other);
+        Container(Container&&) = default;
+        Container& operator=(Container&&) = default;
+
+        /// Registers Type as Interface and every of Interfaces. Singleton and reference counting instance is
+        /// shared by all interfaces. Returns false and registers nothing if one of interfaces is already registered with the name
+        template<class Type, class Interface = Type, class ... Interfaces>
         inline bool Register(std::string_view name = "", const Overrides& overrides = {})
         {
-            const auto type_key = GetTypeKey<Interface>(name);
+            static_assert(internal::AreDistinct<Interface, Interfaces ...>, "Interface can not be listed twice");
 
-            using Factory = internal::Factory<Interface, decltype(SDILTypeTraits<Type>::Create)>;
-            internal::TypeRecord type_record {
-                SDILTypeTraits<Type>::LifeTime,
-                overrides,
-                &Factory::Create,
-                &Factory::Delete
-            };
-            auto insertion_result = type_registry.emplace(type_key, std::move(type_record));
-            return insertion_result.second;
+            // Nothing is registered if one of interfaces is taken
+            if (!CanAddRecord(GetTypeKey<Interface>(name)) || !(CanAddRecord(GetTypeKey<Interfaces>(name)) && ...))
+            {
+                return false;
+            }
+
+            internal::TypeRecord type_record = MakeRecord<Type, Interface>();
+            type_record.overrides = ShareOverrides(overrides);
+            return AddRecord(GetTypeKey<Interface>(name), std::move(type_record))
+                && (RegisterAlias<Type, Interface, Interfaces>(name, overrides) && ...);
+        }
+
+        /// Overrides to be passed to many MakeRegistration calls without copying them
+        static inline std::shared_ptr<const Overrides> MakeOverrides(Overrides overrides)
+        {
+            return std::make_shared<const Overrides>(std::move(overrides));
+        }
+
+        /// Describes registration of Type as Interface for RegisterBatch. Overrides made by MakeOverrides are shared, not copied
+        template<class Type, class Interface = Type>
+        static inline BatchRegistration MakeRegistration(std::string_view name = "", std::shared_ptr<const Overrides> overrides = nullptr)
+        {
+            return BatchRegistration(GetTypeKey<Interface>(name), MakeRecord<Type, Interface>(), std::move(overrides));
         }
 
+        /// Registers table of registrations at once. Keys are sorted and checked in one pass and equal overrides are shared.
+        /// Returns indices of registrations which are not added, because their key is registered already or earlier in the table
+        std::vector<size_t> RegisterBatch(const BatchRegistration* registrations, size_t count);
+
+        inline std::vector<size_t> RegisterBatch(const std::vector<BatchRegistration>& registrations)
+        {
+            return RegisterBatch(registrations.data(), registrations.size());
+        }
+
+        template<size_t Count>
+        inline std::vector<size_t> RegisterBatch(const BatchRegistration (&registrations)[Count])
+        {
+            return RegisterBatch(registrations, Count);
+        }
+
+        /// Removes registration of Interface with the name and drops instance stored for it.
+        /// Returns false if Interface is not registered with the name
+        template<class Interface>
+        inline bool Unregister(std::string_view name = "")
+        {
+            return RemoveRecord(GetTypeKey<Interface>(name));
+        }
+
+        /// Returns container sharing registrations with this one in O(1). Registrations changed after fork
+        /// are copied in chunks, so they are not shared. Instances are not shared, fork creates its own ones
+        Container Fork() const;
+
+        /// Registers placeholders for types provided by module. Library of module is loaded
+        /// and its SDIL_REGISTER_MODULE function is called when one of the types is resolved first time
+        bool RegisterModule(const ModuleManifest& manifest);
+
         template<class Interface, template <class P, class ... PArgs> class Wrapper = SharedPtr>
         inline Wrapper<Interface> Resolve(std::string_view name = "")
         {
             const auto type_key = GetTypeKey<Interface>(name);
 
-            CheckWrapperType(internal::WrapperInfo<Wrapper<Interface>>::GetWrapperType(), type_key);
-            VariantPtr variant_ptr = Resolve(type_key);
+            // Built singleton does not need resolution, and it is returned without touching reference counter
+            if constexpr(std::is_same_v<Wrapper<Interface>, Pointer<Interface>> || std::is_same_v<Wrapper<Interface>, Reference<Interface>>)
+            {
+                if (void* pointer = FindBuiltSingleton(type_key))
+                {
+                    internal::InstancePtr instance{ pointer };
+                    return CastInstanceTo<Interface, Wrapper>(instance);
+                }
+            }
 
-            return CastVariantPtrTo<Interface, Wrapper>(variant_ptr, type_key);
+            internal::InstancePtr instance = Resolve(CheckWrapperType(internal::WrapperInfo<Wrapper<Interface>>::GetWrapperType(), type_key));
+
+            return CastInstanceTo<Interface, Wrapper>(instance);
+        }
+
+        /// Resolves every implementation registered for Interface, in order of registration
+        template<class Interface, template <class P, class ... PArgs> class Wrapper = SharedPtr>
+        inline std::vector<Wrapper<Interface>> ResolveAll()
+        {
+            static_assert(!std::is_reference_v<Wrapper<Interface>>, "References can not be stored in collection");
+
+            std::vector<Wrapper<Interface>> instances;
+            const auto* names = interface_registry.Find(GetTypeId<Interface>());
+            if (names == nullptr)
+            {
+                return instances;
+            }
+
+            // Resolution can load module which registers more implementations, so names are found again
+            instances.reserve(names->second.size());
+            for (size_t index = 0; names != nullptr && index < names->second.size(); ++index)
+            {
+                instances.push_back(Resolve<Interface, Wrapper>(names->second[index]));
+                names = interface_registry.Find(GetTypeId<Interface>());
+            }
+            return instances;
+        }
+
+        /// Resolves factory that creates new instance of Type from runtime arguments on each call.
+        /// Dependencies of Type are resolved once, when factory is resolved, with overrides of Type registered with the name.
+        /// Factory always creates Type itself, so SDILException is thrown if Type is registered with the name as another implementation
+        template<class Signature>
+        inline Factory<Signature> ResolveFactory(std::string_view name = "")
+        {
+            using Type = typename internal::FunctionTraits<Signature>::Return;
+            const auto type_key = GetTypeKey<Type>(name);
+            CheckFactoryType(type_key, GetTypeName<Type>());
+            return Factory<Signature>(this, type_key);
         }
 
         template<class Dependency>
@@ -70,109 +254,471 @@ namespace sdil
             return GetOverride(interface, GetTypeId<Dependency>());
         }
 
+        /// Records spans of resolutions, creations and deletions to tracer. Pass nullptr to stop tracing
+        void SetTracer(std::shared_ptr<Tracer> tracer);
+
+        /// Measures time spent in create of every registration, reported by GetDependencyGraph
+        void SetConstructionTiming(bool enabled);
+
+        /// For tests and benchmarks only. Disabled lookup makes Pointer and Reference to built singleton go through full resolution
+        void SetBuiltSingletonLookup(bool enabled);
+
+        /// Memory used by MemoryTracked instances created by registration, see SDIL_memory.hpp
+        template<class Interface>
+        inline MemoryStats GetMemoryStats(std::string_view name = "") const
+        {
+            return GetMemoryStats(GetTypeKey<Interface>(name));
+        }
+
+        /// Builds graph of registrations and their dependencies, see SDIL_graph.hpp
+        DependencyGraph GetDependencyGraph() const;
+
+        /// Starts recording constructions of singletons in order they are made
+        void StartProfileRecording();
+
+        /// Stops recording and saves constructions with fingerprint of registrations to file.
+        /// Returns false if nothing is recorded or file can not be written
+        bool StopProfileRecording(const std::string& path);
+
+        /// Constructs singletons saved by StopProfileRecording ahead of demand, independent ones in parallel.
+        /// Profile is ignored and false is returned if it is corrupted or registrations have been changed.
+        bool ReplayProfile(const std::string& path, size_t threads = 1);
+
     private:
-        using VariantPtr = std::variant<void*, std::shared_ptr<void>, std::weak_ptr<void>>;
+        /// Record of Type registered as Interface, overrides are set by caller
+        template<class Type, class Interface>
+        static inline internal::TypeRecord MakeRecord()
+        {
+            static_assert(!std::is_base_of_v<MemoryTracked, Type> || alignof(Type) <= alignof(std::max_align_t),
+                    "MemoryTracked type can not be aligned stricter than std::max_align_t");
+
+            using Factory = internal::Factory<Interface, decltype(SDILTypeTraits<Type>::Create)>;
+            return internal::TypeRecord {
+                SDILTypeTraits<Type>::LifeTime,
+                GetTypeName<Interface>(),
+                GetTypeName<Type>(),
+                nullptr,
+                &Factory::Create,
+                &Factory::Delete,
+                SDILTypeTraits<Type>::LifeTime == LifeTimeScope::NotControlled ? nullptr : &FindInstance<SDILTypeTraits<Type>::LifeTime>,
+                &ResolveInstance<SDILTypeTraits<Type>::LifeTime>,
+                &Factory::GetDependencies(),
+                nullptr,
+                nullptr,
+                std::is_base_of_v<MemoryTracked, Type>
+            };
+        }
 
-        void CheckWrapperType(internal::WrapperType wrapper_type, const internal::TypeKey& interface);
-        VariantPtr Resolve(const internal::TypeKey& type_key);
+        template<class Type, class Interface, class Alias>
+        inline bool RegisterAlias(std::string_view name, const Overrides& overrides)
+        {
+            if constexpr (SDILTypeTraits<Type>::LifeTime == LifeTimeScope::NotControlled)
+            {
+                // Instance is not shared anyway
+                return Register<Type, Alias>(name, overrides);
+            }
+            else
+            {
+                // Alias depends on instance registered as Interface and stores it casted to Alias
+                using InterfaceAlias = internal::InterfaceAlias<Type, Interface, Alias>;
+                internal::TypeRecord type_record {
+                    SDILTypeTraits<Type>::LifeTime,
+                    GetTypeName<Alias>(),
+                    GetTypeName<Type>(),
+                    ShareOverrides(Overrides{ { GetTypeId<Interface>(), static_cast<std::string>(name) } }),
+                    &InterfaceAlias::Create,
+                    nullptr,
+                    &FindInstance<SDILTypeTraits<Type>::LifeTime>,
+                    &ResolveAlias,
+                    &InterfaceAlias::GetDependencies(),
+                    nullptr,
+                    nullptr,
+                    false
+                };
+                return AddRecord(GetTypeKey<Alias>(name), std::move(type_record));
+            }
+        }
+
+        bool AddRecord(const internal::TypeKey& type_key, internal::TypeRecord type_record);
+        /// Whether AddRecord would accept record with the key
+        bool CanAddRecord(const internal::TypeKey& type_key) const;
+        bool RemoveRecord(const internal::TypeKey& type_key);
+
+        /// Returns overrides equal to given ones which are shared by records
+        std::shared_ptr<const Overrides> ShareOverrides(const Overrides& overrides);
+        std::shared_ptr<const Overrides> InternOverrides(const std::shared_ptr<const Overrides>& overrides);
+        void LoadModule(std::shared_ptr<const internal::Module> module);
+        const internal::Registration& CheckWrapperType(internal::WrapperType wrapper_type, const internal::TypeKey& interface);
+        /// Throws SDILException if type is registered with implementation other than the one created by factory
+        void CheckFactoryType(const internal::TypeKey& type_key, std::string_view type_name);
+
+        /// Resolves type and its dependencies with explicit stack instead of recursion,
+        /// throws SDILException with path of dependency cycle if type depends on itself
+        internal::InstancePtr Resolve(const internal::TypeKey& type_key);
+        internal::InstancePtr Resolve(const internal::Registration& registration);
+
+        /// Returns instance of singleton which is already built, or nullptr if type should be resolved.
+        /// Tracing, profile recording and profile replay need full resolution, so nullptr is returned for them
+        inline void* FindBuiltSingleton(const internal::TypeKey& type_key) const
+        {
+            if (!built_singleton_lookup || tracer != nullptr || profile_recorder != nullptr || concurrent_access != nullptr)
+            {
+                return nullptr;
+            }
+
+            auto instance_it = singleton_instances.find(type_key);
+            return instance_it == std::cend(singleton_instances) ? nullptr : instance_it->second.get();
+        }
+
+        /// Pushes frame of type with dependencies to resolve stack, or returns its instance if it should not be created
+        bool EnterFrame(internal::ResolveStack& stack, const internal::Registration& registration, internal::InstancePtr& instance);
+        /// Resolves type without dependencies, which can not be a part of cycle, so it needs no frame
+        internal::InstancePtr ResolveLeaf(const internal::Registration& registration);
+        void ResolveDependencies(const internal::TypeKey& type_key, const internal::TypeRecord& type_record, std::vector<internal::InstancePtr>& arguments);
         std::string_view GetOverride(const internal::TypeKey& interface, TypeId dependency);
+        void* Create(const internal::TypeKey& type_key, const internal::TypeRecord& type_record, const internal::Arguments& arguments);
+        SharedPtr<void> CreateShared(const internal::TypeKey& type_key, const internal::TypeRecord& type_record, const internal::Arguments& arguments);
+        uint64_t GetRegistryFingerprint() const;
+        std::shared_ptr<internal::MemoryCounter> GetMemoryCounter(const internal::TypeKey& type_key);
+        MemoryStats GetMemoryStats(const internal::TypeKey& type_key) const;
+
+        /// Locks container while profile is replayed by several threads
+        inline std::unique_lock<std::recursive_mutex> LockConcurrentAccess()
+        {
+            if (concurrent_access == nullptr)
+            {
+                return {};
+            }
+            return std::unique_lock<std::recursive_mutex>(*concurrent_access);
+        }
+
+        /// Finder and resolver of registrations with given lifetime scope, stored in TypeRecord by Register
+        template<LifeTimeScope LifeTime>
+        static internal::InstancePtr FindInstance(Container* container, const internal::TypeKey& type_key, const internal::TypeRecord& type_record);
+        template<LifeTimeScope LifeTime>
+        static internal::InstancePtr ResolveInstance(Container* container, const internal::TypeKey& type_key, const internal::TypeRecord& type_record, const internal::Arguments& arguments);
+
+        /// Resolver of interfaces registered with another interface of the same instance
+        static internal::InstancePtr ResolveAlias(Container* container, const internal::TypeKey& type_key, const internal::TypeRecord& type_record, const internal::Arguments& arguments);
+
+        /// Finder of placeholders registered by RegisterModule, loads module and resolves type registered by it
+        static internal::InstancePtr ResolveModule(Container* container, const internal::TypeKey& type_key, const internal::TypeRecord& type_record);
+
+        template<class Interface, class Signature>
+        friend struct internal::Factory;
+        template<class Signature>
+        friend class Factory;
 
         template<class Type>
-        inline internal::TypeKey GetTypeKey(std::string_view name)
+        static inline internal::TypeKey GetTypeKey(std::string_view name)
         {
             return internal::TypeKey{ GetTypeId<Type>(), static_cast<std::string>(name) };
         }
 
-        std::map<internal::TypeKey, internal::TypeRecord> type_registry;
-        std::map<internal::TypeKey, VariantPtr> instance_registry;
+        internal::ChunkedMap<internal::TypeKey, internal::TypeRecord> type_registry;
+        internal::ChunkedMap<TypeId, std::vector<std::string>> interface_registry;
+        std::set<std::shared_ptr<const Overrides>, internal::OverridesLess> shared_overrides;
+        std::map<internal::TypeKey, SharedPtr<void>> singleton_instances;
+        std::map<internal::TypeKey, WeakPtr<void>> reference_counting_instances;
+        std::shared_ptr<Tracer> tracer;
+        bool construction_timing = false;
+        bool built_singleton_lookup = true;
+        std::map<internal::TypeKey, internal::ConstructionStats> construction_stats;
+        std::map<internal::TypeKey, std::shared_ptr<internal::MemoryCounter>> memory_counters;
+        std::unique_ptr<internal::ProfileRecorder> profile_recorder;
+        std::unique_ptr<std::recursive_mutex> concurrent_access;
+        /// Singletons constructed by profile replay outside of lock
+        std::set<internal::TypeKey> replayed_constructions;
+        std::shared_ptr<const internal::Module> loading_module;
 
         template<class Interface, template <class P, class ... PArgs> class Wrapper>
-        Wrapper<Interface> CastVariantPtrTo(VariantPtr& variant_ptr, const internal::TypeKey& type_key)
+        static Wrapper<Interface> CastInstanceTo(internal::InstancePtr& instance)
         {
-            if (Pointer<void>* pointer = std::get_if<Pointer<void>>(&variant_ptr))
+            auto pointer = static_cast<Pointer<Interface>>(instance.pointer);
+            if constexpr(std::is_same_v<Wrapper<Interface>, UniquePtr<Interface>>)
             {
-                if constexpr(std::is_same_v<Wrapper<Interface>, UniquePtr<Interface>>)
-                {
-                    return UniquePtr<Interface>(static_cast<Interface*>(*pointer));
-                }
-                else if constexpr(std::is_same_v<Wrapper<Interface>, Pointer<Interface>>)
-                {
-                    return static_cast<Pointer<Interface>>(*pointer);
-                }
-                if constexpr(std::is_same_v<Wrapper<Interface>, SharedPtr<Interface>>)
-                {
-                    return SharedPtr<Interface>(static_cast<Interface*>(*pointer), type_registry.find(type_key)->second.deleter);
-                }
+                return UniquePtr<Interface>(pointer);
             }
-            else if (WeakPtr<void>* weak_ptr = std::get_if<WeakPtr<void>>(&variant_ptr))
+            else if constexpr(std::is_same_v<Wrapper<Interface>, Pointer<Interface>>)
             {
-                if constexpr(std::is_same_v<Wrapper<Interface>, WeakPtr<Interface>>)
-                {
-                    return WeakPtr<Interface>(std::static_pointer_cast<Interface>(SharedPtr<void>(*weak_ptr)));
-                }
-                else if constexpr(std::is_same_v<Wrapper<Interface>, SharedPtr<Interface>>)
-                {
-                    return std::static_pointer_cast<Interface>(SharedPtr<void>(*weak_ptr));
-                }
+                return pointer;
             }
-            else if (SharedPtr<void>* shared_ptr = std::get_if<SharedPtr<void>>(&variant_ptr))
+            else if constexpr(std::is_same_v<Wrapper<Interface>, Reference<Interface>>)
             {
-                if constexpr(std::is_same_v<Wrapper<Interface>, SharedPtr<Interface>>)
-                {
-                    return std::static_pointer_cast<Interface>(*shared_ptr);
-                }
-                else if constexpr(std::is_same_v<Wrapper<Interface>, WeakPtr<Interface>>)
+                return *pointer;
+            }
+            else if constexpr(std::is_same_v<Wrapper<Interface>, SharedPtr<Interface>>)
+            {
+                if (instance.owner == nullptr)
                 {
-                    return WeakPtr<Interface>{ std::static_pointer_cast<Interface>(*shared_ptr) };
+                    if (instance.traced_deleter != nullptr)
+                    {
+                        return SharedPtr<Interface>(pointer, [traced_deleter = std::move(instance.traced_deleter)](Interface* deleted)
+                        {
+                            (*traced_deleter)(deleted);
+                        });
+                    }
+                    return SharedPtr<Interface>(pointer, instance.deleter);
                 }
-                else if constexpr(std::is_same_v<Wrapper<Interface>, Pointer<Interface>>)
+                return SharedPtr<Interface>(std::move(instance.owner), pointer);
+            }
+            else if constexpr(std::is_same_v<Wrapper<Interface>, WeakPtr<Interface>>)
+            {
+                return WeakPtr<Interface>(SharedPtr<Interface>(std::move(instance.owner), pointer));
+            }
+            else
+            {
+                throw SDILException("Impossible situation");
+            }
+        }
+    };
+
+    template<>
+    internal::InstancePtr Container::FindInstance<LifeTimeScope::Singleton>(Container* container, const internal::TypeKey& type_key, const internal::TypeRecord& type_record);
+    template<>
+    internal::InstancePtr Container::FindInstance<LifeTimeScope::ReferenceCounting>(Container* container, const internal::TypeKey& type_key, const internal::TypeRecord& type_record);
+    template<>
+    internal::InstancePtr Container::ResolveInstance<LifeTimeScope::NotControlled>(Container* container, const internal::TypeKey& type_key, const internal::TypeRecord& type_record, const internal::Arguments& arguments);
+    template<>
+    internal::InstancePtr Container::ResolveInstance<LifeTimeScope::Singleton>(Container* container, const internal::TypeKey& type_key, const internal::TypeRecord& type_record, const internal::Arguments& arguments);
+    template<>
+    internal::InstancePtr Container::ResolveInstance<LifeTimeScope::ReferenceCounting>(Container* container, const internal::TypeKey& type_key, const internal::TypeRecord& type_record, const internal::Arguments& arguments);
+
+    namespace internal
+    {
+        template<class Instance>
+        inline void Destroy(Instance* instance)
+        {
+            // TODO: Can be replaced with requires C++20
+            if constexpr (SDILTypeTraits<Instance>::HasDeleteFunction)
+            {
+                SDILTypeTraits<Instance>::Delete(instance);
+            }
+            else
+            {
+                delete instance;
+            }
+        }
+
+        template<class Instance>
+        struct Deleter
+        {
+            /// Set for instances created while container is traced
+            std::shared_ptr<const TracedDeleter> traced_deleter;
+
+            void operator()(Instance* instance) const
+            {
+                if (traced_deleter != nullptr)
                 {
-                    return static_cast<Pointer<Interface>>(shared_ptr->get());
+                    (*traced_deleter)(instance);
                 }
-                else if constexpr(std::is_same_v<Wrapper<Interface>, Reference<Interface>>)
+                else
                 {
-                    return *static_cast<Pointer<Interface>>(shared_ptr->get());
+                    Destroy(instance);
                 }
             }
-            throw SDILException("Impossible situation");
+
+            static void Delete(void* instance)
+            {
+                Destroy(static_cast<Instance*>(instance));
+            }
+        };
+
+        template<class Argument>
+        inline Argument ResolveArgument(Container* container, const TypeKey& type_key)
+        {
+            using Dependency = typename WrapperInfo<Argument>::Type;
+            if constexpr (WrapperInfo<Argument>::GetWrapperType() == WrapperType::Collection)
+            {
+                return container->ResolveAll<Dependency, WrapperInfo<Argument>::template Wrapper>();
+            }
+            else if constexpr (WrapperInfo<Argument>::GetWrapperType() == WrapperType::Factory)
+            {
+                return container->ResolveFactory<typename WrapperInfo<Argument>::Signature>(
+                        container->GetOverride<Dependency>(type_key));
+            }
+            else
+            {
+                return container->Resolve<Dependency, WrapperInfo<Argument>::template Wrapper>(
+                        container->GetOverride<Dependency>(type_key));
+            }
         }
-    };
 
-    namespace internal
-    {
         template<class Interface, class ReturnType, class ... Args>
         struct Factory<Interface, ReturnType(Args ...)>
         {
-            static void* Create(Container* container, const TypeKey& type_key)
+            static void* Create(Container* container, const TypeKey& type_key, const Arguments& arguments)
             {
-                Instance* instance = SDILTypeTraits<Instance>::Create(
-                        container->Resolve<typename WrapperInfo<Args>::Type, WrapperInfo<Args>::template Wrapper>(
-                                container->GetOverride<typename WrapperInfo<Args>::Type>(type_key))...
-                                );
-
-                auto interface = static_cast<Interface*>(instance);
-                return interface;
+                return Create(container, type_key, arguments, std::index_sequence_for<Args ...>{});
             }
 
             static void Delete(void* ptr)
             {
                 auto interface = static_cast<Interface*>(ptr);
                 auto instance = static_cast<Instance*>(interface);
-                // TODO: Can be replaced with requires C++20
-                if constexpr (SDILTypeTraits<Instance>::HasDeleteFunction)
+                Destroy(instance);
+            }
+
+            static const std::vector<Dependency>& GetDependencies()
+            {
+                static const std::vector<Dependency> dependencies {
+                    Dependency{
+                        GetTypeId<typename WrapperInfo<Args>::Type>(),
+                        GetTypeName<typename WrapperInfo<Args>::Type>(),
+                        WrapperInfo<Args>::GetWrapperType()
+                    }...
+                };
+                return dependencies;
+            }
+
+            private:
+            using Instance = typename WrapperInfo<ReturnType>::Type;
+
+            template<size_t ... I>
+            static void* Create(Container* container, const TypeKey& type_key, const Arguments& arguments, std::index_sequence<I ...>)
+            {
+                Instance* instance = SDILTypeTraits<Instance>::Create(GetArgument<Args>(container, type_key, arguments, I)...);
+
+                auto interface = static_cast<Interface*>(instance);
+                return interface;
+            }
+
+            /// Converts instance resolved by container to parameter of create, which takes ownership of it
+            template<class Argument>
+            static Argument GetArgument(Container* container, const TypeKey& type_key, const Arguments& arguments, size_t index)
+            {
+                if constexpr (IsResolvedByCreate(WrapperInfo<Argument>::GetWrapperType()))
                 {
-                    SDILTypeTraits<ReturnType>::Delete(instance);
+                    return ResolveArgument<Argument>(container, type_key);
                 }
                 else
                 {
-                    delete instance;
+                    InstancePtr& instance = arguments[index];
+                    Argument argument = Container::CastInstanceTo<typename WrapperInfo<Argument>::Type, WrapperInfo<Argument>::template Wrapper>(instance);
+                    instance.deleter = nullptr;
+                    return argument;
                 }
             }
+        };
+    }
 
-            private:
-            using Instance = typename WrapperInfo<ReturnType>::Type;
+    namespace internal
+    {
+        template<class Type, class Interface, class Alias>
+        struct InterfaceAlias
+        {
+            static void* Create(Container* container, const TypeKey& type_key, const Arguments& arguments)
+            {
+                auto instance = static_cast<Type*>(static_cast<Interface*>(arguments[0].pointer));
+                auto alias = static_cast<Alias*>(instance);
+                return alias;
+            }
+
+            static const std::vector<Dependency>& GetDependencies()
+            {
+                static const std::vector<Dependency> dependencies {
+                    Dependency{ GetTypeId<Interface>(), GetTypeName<Interface>(), WrapperType::Shared }
+                };
+                return dependencies;
+            }
         };
     }
+
+    /// Creates new instances of Type passing runtime arguments as trailing parameters of SDILTypeTraits<Type>::Create.
+    /// Leading parameters are resolved from container once, when factory is resolved, so NotControlled ones
+    /// should be taken as SharedPtr. SDILException is thrown if NotControlled one is taken as raw pointer.
+    /// Instances created by factory are not controlled by container whatever lifetime scope Type has.
+    template<class Type, class ... RuntimeArgs>
+    class Factory<Type(RuntimeArgs ...)>
+    {
+        using CreateTraits = internal::FunctionTraits<decltype(SDILTypeTraits<Type>::Create)>;
+        using CreateArguments = typename CreateTraits::Arguments;
+        using Instance = typename internal::WrapperInfo<typename CreateTraits::Return>::Type;
+
+        static_assert(std::tuple_size_v<CreateArguments> >= sizeof...(RuntimeArgs), "Create has less parameters than runtime arguments");
+        static constexpr size_t InjectedCount = std::tuple_size_v<CreateArguments> >= sizeof...(RuntimeArgs)
+                ? std::tuple_size_v<CreateArguments> - sizeof...(RuntimeArgs)
+                : 0;
+
+        template<size_t ... I>
+        static auto GetInjected(std::index_sequence<I ...>) -> std::tuple<std::tuple_element_t<I, CreateArguments> ...>;
+        template<size_t ... I>
+        static auto GetBound(std::index_sequence<I ...>) -> std::tuple<internal::BoundArgument<std::tuple_element_t<I, CreateArguments>> ...>;
+        template<size_t ... I>
+        static auto GetRuntime(std::index_sequence<I ...>) -> std::tuple<std::tuple_element_t<InjectedCount + I, CreateArguments> ...>;
+
+        using Injected = decltype(GetInjected(std::make_index_sequence<InjectedCount>{}));
+        using Bound = decltype(GetBound(std::make_index_sequence<InjectedCount>{}));
+        static_assert(std::is_same_v<decltype(GetRuntime(std::index_sequence_for<RuntimeArgs ...>{})), std::tuple<RuntimeArgs ...>>,
+                "Runtime arguments should match trailing parameters of Create");
+
+    public:
+        using Result = UniquePtr<Instance, internal::Deleter<Instance>>;
+
+        Result operator()(RuntimeArgs ... args) const
+        {
+            return Call(std::make_index_sequence<InjectedCount>{}, std::forward<RuntimeArgs>(args)...);
+        }
+
+    private:
+        friend class Container;
+
+        Factory(Container* container, const internal::TypeKey& type_key)
+        : bound(Bind(container, type_key, std::make_index_sequence<InjectedCount>{})), type_key(type_key)
+        {
+            if constexpr (std::is_base_of_v<MemoryTracked, Instance>)
+            {
+                memory_counter = container->GetMemoryCounter(type_key);
+            }
+            if (container->tracer != nullptr)
+            {
+                traced_deleter = std::make_shared<const internal::TracedDeleter>(internal::TracedDeleter{
+                    container->tracer, type_key, GetTypeName<Type>(), LifeTimeScope::NotControlled, &internal::Deleter<Instance>::Delete
+                });
+            }
+        }
+
+        template<size_t ... I>
+        static Bound Bind(Container* container, const internal::TypeKey& type_key, std::index_sequence<I ...>)
+        {
+            static_assert(((internal::WrapperInfo<std::tuple_element_t<I, Injected>>::GetWrapperType() != internal::WrapperType::Unique) && ...),
+                    "UniquePtr dependency can not be bound to factory");
+
+            // Every dependency is checked before any is resolved, so nothing is left unreleased if one is rejected
+            (CheckBound<std::tuple_element_t<I, Injected>>(container, type_key), ...);
+            return Bound{ internal::ResolveArgument<std::tuple_element_t<I, Injected>>(container, type_key)... };
+        }
+
+        /// Raw pointer to NotControlled instance passes ownership to create, so it can not be shared by created instances
+        template<class Argument>
+        static void CheckBound(Container* container, const internal::TypeKey& type_key)
+        {
+            using Dependency = typename internal::WrapperInfo<Argument>::Type;
+            if constexpr (internal::WrapperInfo<Argument>::GetWrapperType() == internal::WrapperType::Raw)
+            {
+                const internal::TypeKey dependency_key { GetTypeId<Dependency>(), std::string(container->GetOverride<Dependency>(type_key)) };
+                if (container->CheckWrapperType(internal::WrapperType::Raw, dependency_key).second.lifetime == LifeTimeScope::NotControlled)
+                {
+                    throw SDILException("NotControlled dependency can not be bound to factory as raw pointer, SharedPtr should be requested");
+                }
+            }
+        }
+
+        template<size_t ... I>
+        Result Call(std::index_sequence<I ...>, RuntimeArgs ... args) const
+        {
+            internal::TraceScope trace_scope(traced_deleter != nullptr ? traced_deleter->tracer.get() : nullptr,
+                    internal::SpanKind::Create, type_key, GetTypeName<Type>(), LifeTimeScope::NotControlled);
+            internal::MemoryScope memory_scope(memory_counter);
+            return Result(SDILTypeTraits<Type>::Create(std::get<I>(bound)..., std::forward<RuntimeArgs>(args)...), internal::Deleter<Instance>{ traced_deleter });
+        }
+
+        Bound bound;
+        internal::TypeKey type_key;
+        std::shared_ptr<internal::MemoryCounter> memory_counter;
+        /// Records creations and deletions to tracer which was set when factory was resolved
+        std::shared_ptr<const internal::TracedDeleter> traced_deleter;
+    };
 }
 
 #endif //SDIL_SDIL_HPP
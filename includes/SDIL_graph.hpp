@@ -0,0 +1,48 @@
+#ifndef SDIL_SDIL_GRAPH_HPP
+#define SDIL_SDIL_GRAPH_HPP
+
+#include <ostream>
+
+#include "SDIL.hpp"
+
+namespace sdil
+{
+    /// Graph of registrations built by Container::GetDependencyGraph
+    struct DependencyGraph
+    {
+        struct Node
+        {
+            TypeId type_id;
+            std::string_view interface_name;
+            std::string type_name;
+            /// Empty when dependency is not registered
+            std::string_view implementation_name;
+            LifeTimeScope lifetime;
+            bool registered;
+            /// Measured only if construction timing is enabled in container
+            size_t constructions;
+            std::chrono::nanoseconds construction_time;
+        };
+
+        struct Edge
+        {
+            size_t from;
+            size_t to;
+            internal::WrapperType wrapper_type;
+            /// Dependency is resolved by name from overrides of registration
+            bool overridden;
+        };
+
+        std::vector<Node> nodes;
+        std::vector<Edge> edges;
+
+        /// Chain of dependencies with the longest summary construction time, starting from the dependent node
+        std::vector<size_t> critical_path;
+        std::chrono::nanoseconds critical_path_time {};
+
+        void WriteDot(std::ostream& output) const;
+        void WriteJson(std::ostream& output) const;
+    };
+}
+
+#endif //SDIL_SDIL_GRAPH_HPP
@@ -1,15 +1,28 @@
 #ifndef SDIL_SDIL_INTERNAL_HPP
 #define SDIL_SDIL_INTERNAL_HPP
 
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <set>
 #include <string>
+#include <string_view>
+#include <tuple>
 #include <type_traits>
+#include <vector>
 namespace sdil
 {
     // Forward Declarations
     template<class Type> struct SDILTypeTraits;
+    template<class Signature> class Factory;
     class Container;
+    class Tracer;
+    struct DependencyGraph;
+    struct MemoryTracked;
     using TypeId = size_t;
     using Overrides = std::map<TypeId, std::string>;
 
@@ -62,7 +75,9 @@ namespace sdil
             Reference,
             Unique,
             Shared,
-            Weak
+            Weak,
+            Collection,
+            Factory
         };
 
         template<class T>
@@ -98,6 +113,42 @@ namespace sdil
                 {
                     return WrapperType::Weak;
                 }
+                else
+                {
+                    return WrapperType::None;
+                }
+            };
+        };
+
+        /// Collection of every implementation registered for the element's interface
+        template<class Element>
+        struct WrapperInfo<std::vector<Element>>
+        {
+            using Type = typename WrapperInfo<Element>::Type;
+
+            /// Wrapper of a single element of the collection
+            template<class P, class ... PArgs>
+            using Wrapper = typename WrapperInfo<Element>::template Wrapper<P>;
+
+            constexpr static WrapperType GetWrapperType()
+            {
+                return WrapperType::Collection;
+            };
+        };
+
+        /// Factory creating new instances of T from runtime arguments
+        template<class T, class ... Args>
+        struct WrapperInfo<sdil::Factory<T(Args ...)>>
+        {
+            using Type = T;
+            using Signature = T(Args ...);
+
+            template<class P, class ... PArgs>
+            using Wrapper = NoWrapper<P>;
+
+            constexpr static WrapperType GetWrapperType()
+            {
+                return WrapperType::Factory;
             };
         };
 
@@ -137,34 +188,390 @@ namespace sdil::internal
     template<class Type>
     constexpr bool AlwaysFalse = false;
 
+    template<class ... Types>
+    constexpr bool AreDistinct = true;
+
+    template<class Type, class ... Types>
+    constexpr bool AreDistinct<Type, Types ...> = (!std::is_same_v<Type, Types> && ...) && AreDistinct<Types ...>;
+
+    /// FNV-1a hash
+    constexpr uint64_t Hash(std::string_view string, uint64_t hash = 14695981039346656037ull)
+    {
+        for (char symbol : string)
+        {
+            hash = (hash ^ static_cast<unsigned char>(symbol)) * 1099511628211ull;
+        }
+        return hash;
+    }
+
+    /// Whether type of the name is local to translation unit, i.e. declared in anonymous namespace or in function,
+    /// so another type can have the same name
+    constexpr bool IsLocalTypeName(std::string_view name)
+    {
+        constexpr std::string_view markers[] = { "{anonymous}", "(anonymous namespace)", "`anonymous namespace'", ")::", "'::" };
+        for (std::string_view marker : markers)
+        {
+            if (name.find(marker) != std::string_view::npos) return true;
+        }
+        return false;
+    }
+
     struct TypeKey
     {
         TypeId type_id;
         std::string type_name;
     };
 
-    using FactoryMethod = void*(Container*, const TypeKey&);
+    struct TypeRecord;
     using DeleteMethod = void(void*);
 
+    struct TracedDeleter;
+
+    /// Resolved instance. Owner is set for instances which are controlled by container,
+    /// otherwise caller takes ownership of pointer and releases it with deleter.
+    struct InstancePtr
+    {
+        void* pointer = nullptr;
+        SharedPtr<void> owner;
+        DeleteMethod* deleter = nullptr;
+        /// Wraps deleter of instance created while container is traced
+        std::shared_ptr<const TracedDeleter> traced_deleter;
+    };
+
+    /// Collections and factories are resolved by create itself,
+    /// other dependencies are resolved by container before create is called
+    constexpr bool IsResolvedByCreate(WrapperType wrapper_type)
+    {
+        return wrapper_type == WrapperType::None || wrapper_type == WrapperType::Collection || wrapper_type == WrapperType::Factory;
+    }
+
+    /// Instances resolved for parameters of create, indexed as dependencies of type.
+    /// Instances are addressed by index because create can resolve more instances while they are used.
+    struct Arguments
+    {
+        std::vector<InstancePtr>* instances;
+        size_t begin;
+
+        InstancePtr& operator[](size_t index) const
+        {
+            return (*instances)[begin + index];
+        }
+    };
+
+    /// Deletes instances from begin which have not been passed to create and are not owned by container
+    void ReleaseArguments(std::vector<InstancePtr>& instances, size_t begin);
+
+    using FactoryMethod = void*(Container*, const TypeKey&, const Arguments&);
+
+    /// Returns instance stored for type, or empty instance if it should be created
+    using FindMethod = InstancePtr(Container*, const TypeKey&, const TypeRecord&);
+
+    /// Creates instance from resolved arguments and stores it according to lifetime scope
+    using ResolveMethod = InstancePtr(Container*, const TypeKey&, const TypeRecord&, const Arguments&);
+
+    /// Parameter of Create function
+    struct Dependency
+    {
+        TypeId type_id;
+        std::string_view interface_name;
+        WrapperType wrapper_type;
+    };
+
+    struct ModuleType
+    {
+        TypeId type_id;
+        std::string_view interface_name;
+        std::string type_name;
+    };
+
+    /// Shared library registering types on load
+    struct Module
+    {
+        std::string library_path;
+        std::vector<ModuleType> types;
+    };
+
     struct TypeRecord
     {
         LifeTimeScope lifetime;
-        Overrides overrides;
+        std::string_view interface_name;
+        std::string_view implementation_name;
+        /// Shared by records with equal overrides
+        std::shared_ptr<const Overrides> overrides;
         FactoryMethod* create;
         DeleteMethod* deleter;
+        /// Not set for NotControlled types, their instances are never shared so there is nothing to find
+        FindMethod* find;
+        ResolveMethod* resolve;
+        const std::vector<Dependency>* dependencies;
+        /// Set for placeholders of types provided by module which is not loaded yet
+        std::shared_ptr<const Module> module;
+        /// Set for types registered by module when it has been loaded
+        std::shared_ptr<const Module> loaded_module;
+        /// Type derives from MemoryTracked
+        bool memory_tracked;
     };
 
+    /// Entry of type registry
+    using Registration = std::pair<const TypeKey, TypeRecord>;
+
+    struct MemoryCounter;
+    struct ResolveStack;
+
+    /// Accounts MemoryTracked instances allocated on the thread to counter till the scope ends, does nothing if counter is nullptr
+    class MemoryScope
+    {
+    public:
+        explicit MemoryScope(std::shared_ptr<MemoryCounter> counter)
+        : counter(std::move(counter))
+        {
+            if (this->counter != nullptr)
+            {
+                Enter();
+            }
+        }
+
+        MemoryScope(const MemoryScope&) = delete;
+        MemoryScope& operator=(const MemoryScope&) = delete;
+
+        ~MemoryScope()
+        {
+            if (counter != nullptr)
+            {
+                Leave();
+            }
+        }
+
+    private:
+        void Enter();
+        void Leave();
+
+        std::shared_ptr<MemoryCounter> counter;
+        const std::shared_ptr<MemoryCounter>* previous = nullptr;
+    };
+
+    enum class SpanKind
+    {
+        Resolve,
+        Create,
+        Delete
+    };
+
+    struct Span
+    {
+        SpanKind kind;
+        TypeId type_id;
+        std::string_view interface_name;
+        std::string type_name;
+        LifeTimeScope lifetime;
+        std::chrono::nanoseconds begin;
+        std::chrono::nanoseconds end;
+    };
+
+    /// Records span from construction till destruction, does nothing if tracer is nullptr
+    class TraceScope
+    {
+    public:
+        TraceScope(Tracer* tracer, SpanKind kind, const TypeKey& type_key, std::string_view interface_name, LifeTimeScope lifetime)
+        : tracer(tracer)
+        {
+            if (tracer != nullptr)
+            {
+                Begin(kind, type_key, interface_name, lifetime);
+            }
+        }
+
+        TraceScope(Tracer* tracer, SpanKind kind, const TypeKey& type_key, const TypeRecord& type_record)
+        : TraceScope(tracer, kind, type_key, type_record.interface_name, type_record.lifetime)
+        {
+        }
+
+        TraceScope(const TraceScope&) = delete;
+        TraceScope& operator=(const TraceScope&) = delete;
+
+        ~TraceScope()
+        {
+            if (tracer != nullptr)
+            {
+                End();
+            }
+        }
+
+    private:
+        void Begin(SpanKind kind, const TypeKey& type_key, std::string_view interface_name, LifeTimeScope lifetime);
+        void End();
+
+        Tracer* tracer;
+        Span span;
+    };
+
+    /// Deleter of instances created while tracing, records span of deletion
+    struct TracedDeleter
+    {
+        std::shared_ptr<Tracer> tracer;
+        TypeKey type_key;
+        std::string_view interface_name;
+        LifeTimeScope lifetime;
+        DeleteMethod* deleter;
+
+        void operator()(void* ptr) const;
+    };
+
+    struct ConstructionStats
+    {
+        size_t constructions = 0;
+        /// Time spent in create excluding creation of dependencies
+        std::chrono::nanoseconds construction_time {};
+    };
+
+    /// Constructions of singletons recorded in order of completion
+    struct ProfileRecorder
+    {
+        struct Entry
+        {
+            TypeKey type_key;
+            /// Indices of recorded entries used by construction
+            std::vector<uint32_t> dependencies;
+        };
+
+        void BeginConstruction();
+        void EndConstruction(const TypeKey& type_key);
+        void AbortConstruction();
+        void AddDependency(const TypeKey& type_key);
+
+        std::vector<Entry> entries;
+        std::map<TypeKey, uint32_t> indices;
+        /// Dependencies of constructions in progress
+        std::vector<std::vector<uint32_t>> frames;
+    };
+
+    /// Thrown when profile replay needs singleton which is being constructed by another thread,
+    /// construction which needs it is repeated after the others
+    struct ReplayConflict { };
+
+    const char* ToString(LifeTimeScope lifetime);
+    const char* ToString(WrapperType wrapper_type);
+    void WriteJsonString(std::ostream& output, std::string_view string);
+
     inline bool operator<(const TypeKey& left, const TypeKey& right) noexcept
     {
         if (left.type_id != right.type_id) return left.type_id < right.type_id;
         return left.type_name < right.type_name;
     }
 
+    /// Ids of local types are function addresses with zero low bits, so bits are mixed before low bits select chunk
+    inline uint64_t GetChunkHash(TypeId type_id)
+    {
+        return (static_cast<uint64_t>(type_id) * 0x9E3779B97F4A7C15ull) >> 32;
+    }
+
+    inline uint64_t GetChunkHash(const TypeKey& type_key)
+    {
+        return Hash(type_key.type_name, type_key.type_id);
+    }
+
+    /// Map split to chunks by hash of key. Chunks are shared between copies of map and copied before they are changed,
+    /// so map is copied in O(1) and change of copy costs copy of one chunk
+    template<class Key, class Value>
+    class ChunkedMap
+    {
+    public:
+        using Chunk = std::map<Key, Value>;
+        using Entry = typename Chunk::value_type;
+        static constexpr size_t ChunksCount = 64;
+
+        static size_t GetChunkIndex(const Key& key)
+        {
+            return static_cast<size_t>(GetChunkHash(key) % ChunksCount);
+        }
+
+        const Entry* Find(const Key& key) const
+        {
+            const std::shared_ptr<Chunk>& chunk = (*chunks)[GetChunkIndex(key)];
+            if (chunk == nullptr) return nullptr;
+
+            auto entry_it = chunk->find(key);
+            if (entry_it == std::cend(*chunk)) return nullptr;
+            return &*entry_it;
+        }
+
+        /// Chunk which is not shared with other maps, entries of chunk can be changed
+        Chunk& GetMutableChunk(size_t index)
+        {
+            if (chunks.use_count() > 1)
+            {
+                chunks = std::make_shared<Chunks>(*chunks);
+            }
+
+            std::shared_ptr<Chunk>& chunk = (*chunks)[index];
+            if (chunk == nullptr)
+            {
+                chunk = std::make_shared<Chunk>();
+            }
+            else if (chunk.use_count() > 1)
+            {
+                chunk = std::make_shared<Chunk>(*chunk);
+            }
+            return *chunk;
+        }
+
+        template<class Function>
+        void ForEach(Function&& function) const
+        {
+            for (const std::shared_ptr<Chunk>& chunk : *chunks)
+            {
+                if (chunk == nullptr) continue;
+                for (const Entry& entry : *chunk)
+                {
+                    function(entry);
+                }
+            }
+        }
+
+    private:
+        using Chunks = std::array<std::shared_ptr<Chunk>, ChunksCount>;
+
+        std::shared_ptr<Chunks> chunks = std::make_shared<Chunks>();
+    };
+
+    /// Orders shared overrides by their content
+    struct OverridesLess
+    {
+        using is_transparent = void;
+
+        bool operator()(const std::shared_ptr<const Overrides>& left, const std::shared_ptr<const Overrides>& right) const { return *left < *right; }
+        bool operator()(const std::shared_ptr<const Overrides>& left, const Overrides& right) const { return *left < right; }
+        bool operator()(const Overrides& left, const std::shared_ptr<const Overrides>& right) const { return left < *right; }
+    };
+
     template<class Interface, class FactoryFunctionType>
     struct Factory
     {
         static_assert(AlwaysFalse<FactoryFunctionType>, "Type should be functional type");
     };
+
+    /// Record of implementation registered as Interface resolved as another of its interfaces, see Container::Register
+    template<class Type, class Interface, class Alias>
+    struct InterfaceAlias;
+
+    template<class FunctionType>
+    struct FunctionTraits
+    {
+        static_assert(AlwaysFalse<FunctionType>, "Type should be functional type");
+    };
+
+    template<class ReturnType, class ... Args>
+    struct FunctionTraits<ReturnType(Args ...)>
+    {
+        using Return = ReturnType;
+        using Arguments = std::tuple<Args ...>;
+    };
+
+    /// Type used to keep argument bound to sdil::Factory between calls
+    template<class Argument>
+    using BoundArgument = std::conditional_t<std::is_reference_v<Argument>,
+            std::reference_wrapper<std::remove_reference_t<Argument>>,
+            std::decay_t<Argument>>;
 }
 
 namespace std
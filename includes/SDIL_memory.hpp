@@ -0,0 +1,46 @@
+#ifndef SDIL_SDIL_MEMORY_HPP
+#define SDIL_SDIL_MEMORY_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+
+#include "SDIL.hpp"
+
+namespace sdil
+{
+    /// Base of types whose memory is accounted to registration they are created by, see Container::GetMemoryStats.
+    /// Instances are accounted till they are deleted, also after they have left container as UniquePtr or raw pointer.
+    struct MemoryTracked
+    {
+        static void* operator new(size_t size);
+        static void* operator new(size_t size, const std::nothrow_t&) noexcept;
+        static void operator delete(void* pointer);
+        static void operator delete(void* pointer, const std::nothrow_t&) noexcept;
+
+        /// Instance constructed in given memory is not accounted
+        static void* operator new(size_t size, void* place) noexcept { return place; }
+        static void operator delete(void* pointer, void* place) noexcept { }
+
+        /// Accounting header is aligned as std::max_align_t, so stricter aligned types can not be tracked
+        static void* operator new(size_t size, std::align_val_t alignment) = delete;
+        static void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) = delete;
+    };
+
+    namespace internal
+    {
+        struct MemoryCounter
+        {
+            void Allocate(size_t size);
+            void Deallocate(size_t size);
+            MemoryStats GetStats() const;
+
+            std::atomic<size_t> live_instances { 0 };
+            std::atomic<size_t> live_bytes { 0 };
+            std::atomic<size_t> peak_bytes { 0 };
+            std::atomic<size_t> allocations { 0 };
+        };
+    }
+}
+
+#endif //SDIL_SDIL_MEMORY_HPP
@@ -0,0 +1,46 @@
+#ifndef SDIL_SDIL_TRACING_HPP
+#define SDIL_SDIL_TRACING_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <thread>
+
+#include "SDIL.hpp"
+
+namespace sdil
+{
+    /// Collects spans of resolutions, creations and deletions made by containers.
+    /// Spans are buffered per thread and can be written as Chrome/Perfetto trace-event JSON.
+    class Tracer
+    {
+    public:
+        Tracer();
+        Tracer(const Tracer&) = delete;
+        Tracer& operator=(const Tracer&) = delete;
+
+        /// Writes spans recorded so far. Should not be called while spans are recorded.
+        void WriteChromeTrace(std::ostream& output) const;
+
+        std::chrono::nanoseconds Now() const;
+        void Record(internal::Span&& span);
+
+    private:
+        struct ThreadBuffer
+        {
+            std::thread::id thread_id;
+            size_t thread_index;
+            std::vector<internal::Span> spans;
+        };
+
+        ThreadBuffer& GetThreadBuffer();
+
+        const uint64_t id;
+        const std::chrono::steady_clock::time_point origin;
+        mutable std::mutex mutex;
+        std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    };
+}
+
+#endif //SDIL_SDIL_TRACING_HPP
@@ -1,103 +1,853 @@
 #include "SDIL.hpp"
+#include "SDIL_tracing.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <ostream>
 
 namespace sdil
 {
 #define TO_STRING(symbol) #symbol
 
-    Container::VariantPtr Container::Resolve(const internal::TypeKey &type_key) {
-        auto type_record_it = type_registry.find(type_key);
-        if (type_record_it == std::cend(type_registry))
+    namespace internal
+    {
+        /// Measures construction time of instance excluding construction of its dependencies
+        class ConstructionTimer
         {
-            throw SDILException("Type is not registered. Use " TO_STRING(Container::Register) " to register the type");
+        public:
+            explicit ConstructionTimer(ConstructionStats* stats)
+            : stats(stats)
+            {
+                if (stats != nullptr)
+                {
+                    parent = current;
+                    current = this;
+                    begin = std::chrono::steady_clock::now();
+                }
+            }
+
+            ConstructionTimer(const ConstructionTimer&) = delete;
+            ConstructionTimer& operator=(const ConstructionTimer&) = delete;
+
+            ~ConstructionTimer()
+            {
+                if (stats != nullptr)
+                {
+                    const auto elapsed = std::chrono::steady_clock::now() - begin;
+                    stats->constructions++;
+                    stats->construction_time += std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed - dependencies_time);
+                    if (parent != nullptr)
+                    {
+                        parent->dependencies_time += elapsed;
+                    }
+                    current = parent;
+                }
+            }
+
+        private:
+            static thread_local ConstructionTimer* current;
+
+            ConstructionStats* stats;
+            ConstructionTimer* parent = nullptr;
+            std::chrono::steady_clock::time_point begin;
+            std::chrono::steady_clock::duration dependencies_time {};
+        };
+
+        thread_local ConstructionTimer* ConstructionTimer::current = nullptr;
+
+        /// Type which is being resolved by Container::Resolve
+        struct ResolveFrame
+        {
+            const Registration* registration;
+            /// Next dependency to resolve
+            size_t dependency;
+            /// First argument of the type in resolve stack
+            size_t arguments;
+            std::chrono::nanoseconds trace_begin;
+        };
+
+        /// Frames of records which are being resolved, open addressing table keyed by address of record.
+        /// Records can be shared by forks of container, so they are marked per thread
+        class ResolveMarks
+        {
+        public:
+            /// Returns frame of record plus one, zero if record is not being resolved
+            size_t Find(const TypeRecord* record) const
+            {
+                if (count == 0) return 0;
+                for (size_t index = GetSlot(record); slots[index].record != nullptr; index = (index + 1) & mask)
+                {
+                    if (slots[index].record == record) return slots[index].frame;
+                }
+                return 0;
+            }
+
+            void Insert(const TypeRecord* record, size_t frame)
+            {
+                if ((count + 1) * 2 > slots.size())
+                {
+                    Grow();
+                }
+                size_t index = GetSlot(record);
+                while (slots[index].record != nullptr)
+                {
+                    index = (index + 1) & mask;
+                }
+                slots[index] = { record, frame };
+                ++count;
+            }
+
+            void Erase(const TypeRecord* record)
+            {
+                size_t index = GetSlot(record);
+                while (slots[index].record != record)
+                {
+                    index = (index + 1) & mask;
+                }
+
+                // Following slots are shifted back, so no slot is left behind an empty one
+                for (size_t next = (index + 1) & mask; slots[next].record != nullptr; next = (next + 1) & mask)
+                {
+                    const size_t slot = GetSlot(slots[next].record);
+                    if (((next - slot) & mask) >= ((next - index) & mask))
+                    {
+                        slots[index] = slots[next];
+                        index = next;
+                    }
+                }
+                slots[index] = {};
+                --count;
+            }
+
+        private:
+            struct Slot
+            {
+                const TypeRecord* record = nullptr;
+                size_t frame = 0;
+            };
+
+            size_t GetSlot(const TypeRecord* record) const
+            {
+                return static_cast<size_t>((reinterpret_cast<uintptr_t>(record) * 0x9E3779B97F4A7C15ull) >> shift);
+            }
+
+            void Grow()
+            {
+                std::vector<Slot> previous = std::move(slots);
+                slots.assign(previous.empty() ? 16 : previous.size() * 2, Slot{});
+                mask = slots.size() - 1;
+                shift = 64;
+                for (size_t size = slots.size(); size > 1; size >>= 1)
+                {
+                    --shift;
+                }
+                count = 0;
+                for (const Slot& slot : previous)
+                {
+                    if (slot.record != nullptr) Insert(slot.record, slot.frame);
+                }
+            }
+
+            std::vector<Slot> slots;
+            size_t count = 0;
+            size_t mask = 0;
+            unsigned shift = 64;
+        };
+
+        /// Explicit stack of Container::Resolve, shared by nested resolutions made on thread
+        struct ResolveStack
+        {
+            /// Frames of shallow stack are scanned, deeper frames are marked
+            static constexpr size_t ScannedFrames = 16;
+
+            /// Returns frame of record plus one, zero if record is not being resolved
+            size_t Find(const TypeRecord* record) const
+            {
+                const size_t scanned = std::min(frames.size(), ScannedFrames);
+                for (size_t index = 0; index < scanned; ++index)
+                {
+                    if (&frames[index].registration->second == record)
+                    {
+                        return index + 1;
+                    }
+                }
+                return marks.Find(record);
+            }
+
+            void Push(const ResolveFrame& frame)
+            {
+                frames.push_back(frame);
+                if (frames.size() > ScannedFrames)
+                {
+                    marks.Insert(&frame.registration->second, frames.size());
+                }
+            }
+
+            void Pop()
+            {
+                if (frames.size() > ScannedFrames)
+                {
+                    marks.Erase(&frames.back().registration->second);
+                }
+                frames.pop_back();
+            }
+
+            std::vector<ResolveFrame> frames;
+            std::vector<InstancePtr> arguments;
+            ResolveMarks marks;
+        };
+
+        thread_local ResolveStack resolve_stack;
+
+        void RecordResolveSpan(Tracer* tracer, const Registration& registration, std::chrono::nanoseconds begin)
+        {
+            if (tracer != nullptr)
+            {
+                const auto& [type_key, type_record] = registration;
+                tracer->Record(Span{ SpanKind::Resolve, type_key.type_id, type_record.interface_name, type_key.type_name, type_record.lifetime, begin, tracer->Now() });
+            }
         }
 
-        internal::TypeRecord& type_record = type_record_it->second;
-        if(type_record.lifetime != LifeTimeScope::NotControlled)
+        void LeaveFrame(Tracer* tracer, ResolveStack& stack)
         {
-            auto variant_it = instance_registry.find(type_key);
-            if (variant_it != std::cend(instance_registry))
+            const ResolveFrame& frame = stack.frames.back();
+            RecordResolveSpan(tracer, *frame.registration, frame.trace_begin);
+            ReleaseArguments(stack.arguments, frame.arguments);
+            stack.Pop();
+        }
+
+        /// Restores resolve stack if resolution of the last entered frame fails
+        class ResolveScope
+        {
+        public:
+            ResolveScope(ResolveStack& stack, Tracer* tracer, ProfileRecorder* recorder)
+            : stack(stack), tracer(tracer), recorder(recorder), frames(stack.frames.size() - 1), arguments(stack.frames.back().arguments)
             {
-                VariantPtr& variant_ptr = variant_it->second;
+            }
+
+            ResolveScope(const ResolveScope&) = delete;
+            ResolveScope& operator=(const ResolveScope&) = delete;
 
-                if (WeakPtr<void>* weak_ptr = std::get_if<WeakPtr<void>>(&variant_ptr))
+            ~ResolveScope()
+            {
+                while (stack.frames.size() > frames)
                 {
-                    SharedPtr<void> instance = weak_ptr->lock();
-                    if (instance != nullptr)
+                    // Construction of singleton is recorded from its find till its resolve
+                    if (recorder != nullptr && stack.frames.back().registration->second.lifetime == LifeTimeScope::Singleton)
                     {
-                        return instance;
+                        recorder->AbortConstruction();
+                    }
+                    LeaveFrame(tracer, stack);
+                }
+                ReleaseArguments(stack.arguments, arguments);
+            }
+
+            size_t Frames() const
+            {
+                return frames;
+            }
+
+        private:
+            ResolveStack& stack;
+            Tracer* tracer;
+            ProfileRecorder* recorder;
+            const size_t frames;
+            const size_t arguments;
+        };
+
+        void ReleaseArguments(std::vector<InstancePtr>& instances, size_t begin)
+        {
+            for (size_t index = begin; index < instances.size(); ++index)
+            {
+                InstancePtr& instance = instances[index];
+                if (instance.owner == nullptr && instance.deleter != nullptr)
+                {
+                    if (instance.traced_deleter != nullptr)
+                    {
+                        (*instance.traced_deleter)(instance.pointer);
                     }
                     else
                     {
-                        instance.reset(type_record.create(this, type_key), type_record.deleter);
-                        switch (type_record.lifetime) {
-                            case LifeTimeScope::Singleton:
-                                instance_registry.insert_or_assign(variant_it, type_key, VariantPtr{ instance });
-                                break;
-                            case LifeTimeScope::ReferenceCounting:
-                                *weak_ptr = instance;
-                                break;
-                            case LifeTimeScope::NotControlled:
-                            default:
-                                throw SDILException("Unexpected lifetime scope");
-                        }
-                        return instance;
+                        instance.deleter(instance.pointer);
                     }
                 }
-                else if (std::holds_alternative<SharedPtr<void>>(variant_ptr))
+            }
+            instances.resize(begin);
+        }
+
+        std::string ToString(const TypeKey& type_key, const TypeRecord& type_record)
+        {
+            std::string name(type_record.interface_name);
+            if (!type_key.type_name.empty())
+            {
+                name += "[" + type_key.type_name + "]";
+            }
+            return name;
+        }
+
+        const char* ToString(LifeTimeScope lifetime)
+        {
+            switch (lifetime)
+            {
+                case LifeTimeScope::NotControlled: return "NotControlled";
+                case LifeTimeScope::Singleton: return "Singleton";
+                case LifeTimeScope::ReferenceCounting: return "ReferenceCounting";
+            }
+            return "Unknown";
+        }
+
+        const char* ToString(WrapperType wrapper_type)
+        {
+            switch (wrapper_type)
+            {
+                case WrapperType::None: return "none";
+                case WrapperType::Raw: return "raw";
+                case WrapperType::Reference: return "reference";
+                case WrapperType::Unique: return "unique";
+                case WrapperType::Shared: return "shared";
+                case WrapperType::Weak: return "weak";
+                case WrapperType::Collection: return "collection";
+                case WrapperType::Factory: return "factory";
+            }
+            return "unknown";
+        }
+
+        void WriteJsonString(std::ostream& output, std::string_view string)
+        {
+            output << '"';
+            for (char symbol : string)
+            {
+                switch (symbol)
+                {
+                    case '"': output << "\\\""; break;
+                    case '\\': output << "\\\\"; break;
+                    case '\n': output << "\\n"; break;
+                    case '\t': output << "\\t"; break;
+                    default:
+                        if (static_cast<unsigned char>(symbol) < 0x20)
+                        {
+                            constexpr const char* digits = "0123456789abcdef";
+                            output << "\\u00" << digits[symbol >> 4] << digits[symbol & 0xF];
+                        }
+                        else
+                        {
+                            output << symbol;
+                        }
+                }
+            }
+            output << '"';
+        }
+    }
+
+    internal::InstancePtr Container::Resolve(const internal::TypeKey &type_key) {
+        const internal::Registration* registration = type_registry.Find(type_key);
+        if (registration == nullptr)
+        {
+            throw SDILException("Type is not registered. Use " TO_STRING(Container::Register) " to register the type");
+        }
+        return Resolve(*registration);
+    }
+
+    internal::InstancePtr Container::Resolve(const internal::Registration& registration)
+    {
+        auto lock = LockConcurrentAccess();
+        if (registration.second.dependencies->empty())
+        {
+            return ResolveLeaf(registration);
+        }
+
+        internal::ResolveStack& stack = internal::resolve_stack;
+        internal::InstancePtr instance;
+        if (!EnterFrame(stack, registration, instance))
+        {
+            return instance;
+        }
+
+        internal::ResolveScope resolve_scope(stack, tracer.get(), profile_recorder.get());
+
+        while (stack.frames.size() > resolve_scope.Frames())
+        {
+            // Frames and arguments can be reallocated by nested resolutions, so they are accessed by index
+            const size_t frame_index = stack.frames.size() - 1;
+            const auto& [frame_key, frame_record] = *stack.frames[frame_index].registration;
+            const std::vector<internal::Dependency>& dependencies = *frame_record.dependencies;
+
+            bool entered = false;
+            while (!entered && stack.frames[frame_index].dependency < dependencies.size())
+            {
+                const internal::Dependency& dependency = dependencies[stack.frames[frame_index].dependency++];
+                stack.arguments.emplace_back();
+                if (internal::IsResolvedByCreate(dependency.wrapper_type))
                 {
-                    return variant_ptr;
+                    continue;
                 }
-                else
+
+                auto override_it = frame_record.overrides->find(dependency.type_id);
+                const internal::TypeKey dependency_key {
+                    dependency.type_id,
+                    override_it == std::cend(*frame_record.overrides) ? std::string() : override_it->second
+                };
+                const size_t argument_index = stack.arguments.size() - 1;
+                const internal::Registration& dependency_registration = CheckWrapperType(dependency.wrapper_type, dependency_key);
+                if (dependency_registration.second.dependencies->empty())
                 {
-                    throw SDILException("Unexpected content of variant");
+                    // Arguments can be reallocated by resolution, so argument is indexed after it is resolved
+                    stack.arguments[argument_index] = ResolveLeaf(dependency_registration);
+                    continue;
                 }
+
+                internal::InstancePtr argument;
+                // Argument of entered dependency is filled when its frame is left
+                entered = EnterFrame(stack, dependency_registration, argument);
+                stack.arguments[argument_index] = std::move(argument);
             }
-            else
+
+            if (entered)
             {
-                SharedPtr<void> instance {type_record.create(this, type_key) , type_record.deleter} ;
-                VariantPtr variant_ptr;
-                switch (type_record.lifetime) {
-                    case LifeTimeScope::Singleton:
-                        variant_ptr = instance;
-                        break;
-                    case LifeTimeScope::ReferenceCounting:
-                        variant_ptr = WeakPtr<void>{ instance };
-                        break;
-                    case LifeTimeScope::NotControlled:
-                    default:
-                        throw SDILException("Impossible situation. 2ed if-clause above must not allow achieve this code");
+                continue;
+            }
+
+            // Frame stays in stack while instance is created, so cycles through collections and factories are detected too
+            instance = frame_record.resolve(this, frame_key, frame_record, internal::Arguments{ &stack.arguments, stack.frames[frame_index].arguments });
+            internal::LeaveFrame(tracer.get(), stack);
+            if (stack.frames.size() > resolve_scope.Frames())
+            {
+                stack.arguments.back() = std::move(instance);
+            }
+        }
+        return instance;
+    }
+
+    bool Container::EnterFrame(internal::ResolveStack& stack, const internal::Registration& registration, internal::InstancePtr& instance)
+    {
+        const auto& [type_key, type_record] = registration;
+        if (const size_t frame = stack.Find(&type_record); frame != 0)
+        {
+            std::string cycle;
+            for (size_t index = frame - 1; index < stack.frames.size(); ++index)
+            {
+                const auto& [frame_key, frame_record] = *stack.frames[index].registration;
+                cycle += internal::ToString(frame_key, frame_record) + " -> ";
+            }
+            throw SDILException("Dependency cycle: " + cycle + internal::ToString(type_key, type_record));
+        }
+
+        const std::chrono::nanoseconds trace_begin = tracer != nullptr ? tracer->Now() : std::chrono::nanoseconds{};
+        if (type_record.find != nullptr)
+        {
+            instance = type_record.find(this, type_key, type_record);
+        }
+        if (instance.pointer != nullptr)
+        {
+            internal::RecordResolveSpan(tracer.get(), registration, trace_begin);
+            return false;
+        }
+
+        stack.Push({ &registration, 0, stack.arguments.size(), trace_begin });
+        return true;
+    }
+
+    internal::InstancePtr Container::ResolveLeaf(const internal::Registration& registration)
+    {
+        const auto& [type_key, type_record] = registration;
+        const std::chrono::nanoseconds trace_begin = tracer != nullptr ? tracer->Now() : std::chrono::nanoseconds{};
+        internal::InstancePtr instance = type_record.find != nullptr ? type_record.find(this, type_key, type_record) : internal::InstancePtr{};
+        if (instance.pointer == nullptr)
+        {
+            try
+            {
+                instance = type_record.resolve(this, type_key, type_record, internal::Arguments{ nullptr, 0 });
+            }
+            catch (...)
+            {
+                // Construction of singleton is recorded from its find till its resolve
+                if (profile_recorder != nullptr && type_record.lifetime == LifeTimeScope::Singleton)
+                {
+                    profile_recorder->AbortConstruction();
                 }
+                internal::RecordResolveSpan(tracer.get(), registration, trace_begin);
+                throw;
+            }
+        }
+        internal::RecordResolveSpan(tracer.get(), registration, trace_begin);
+        return instance;
+    }
+
+    void Container::ResolveDependencies(const internal::TypeKey& type_key, const internal::TypeRecord& type_record, std::vector<internal::InstancePtr>& arguments)
+    {
+        for (const internal::Dependency& dependency : *type_record.dependencies)
+        {
+            internal::InstancePtr& argument = arguments.emplace_back();
+            if (!internal::IsResolvedByCreate(dependency.wrapper_type))
+            {
+                const internal::TypeKey dependency_key { dependency.type_id, std::string(GetOverride(type_key, dependency.type_id)) };
+                argument = Resolve(CheckWrapperType(dependency.wrapper_type, dependency_key));
+            }
+        }
+    }
+
+    void* Container::Create(const internal::TypeKey& type_key, const internal::TypeRecord& type_record, const internal::Arguments& arguments)
+    {
+        // Nothing is measured, so create is called without scopes
+        if (tracer == nullptr && !construction_timing && !type_record.memory_tracked)
+        {
+            return type_record.create(this, type_key, arguments);
+        }
+
+        internal::TraceScope trace_scope(tracer.get(), internal::SpanKind::Create, type_key, type_record);
+        internal::ConstructionStats* stats = nullptr;
+        if (construction_timing)
+        {
+            auto lock = LockConcurrentAccess();
+            stats = &construction_stats[type_key];
+        }
 
-                instance_registry.emplace(type_key, variant_ptr);
-                return instance;
+        internal::ConstructionTimer construction_timer(stats);
+        internal::MemoryScope memory_scope(type_record.memory_tracked ? GetMemoryCounter(type_key) : nullptr);
+        return type_record.create(this, type_key, arguments);
+    }
+
+    SharedPtr<void> Container::CreateShared(const internal::TypeKey& type_key, const internal::TypeRecord& type_record, const internal::Arguments& arguments)
+    {
+        void* instance = Create(type_key, type_record, arguments);
+        if (tracer != nullptr)
+        {
+            return SharedPtr<void>(instance, internal::TracedDeleter{ tracer, type_key, type_record.interface_name, type_record.lifetime, type_record.deleter });
+        }
+        return SharedPtr<void>(instance, type_record.deleter);
+    }
+
+    template<>
+    internal::InstancePtr Container::FindInstance<LifeTimeScope::Singleton>(Container* container, const internal::TypeKey& type_key, const internal::TypeRecord& type_record)
+    {
+        auto instance_it = container->singleton_instances.find(type_key);
+        if (instance_it != std::cend(container->singleton_instances))
+        {
+            if (container->profile_recorder != nullptr)
+            {
+                container->profile_recorder->AddDependency(type_key);
             }
+            return { instance_it->second.get(), instance_it->second, nullptr };
+        }
+
+        if (container->concurrent_access != nullptr && container->replayed_constructions.count(type_key) != 0)
+        {
+            throw internal::ReplayConflict{};
+        }
+        if (container->profile_recorder != nullptr)
+        {
+            container->profile_recorder->BeginConstruction();
+        }
+        return {};
+    }
+
+    template<>
+    internal::InstancePtr Container::FindInstance<LifeTimeScope::ReferenceCounting>(Container* container, const internal::TypeKey& type_key, const internal::TypeRecord& type_record)
+    {
+        auto instance_it = container->reference_counting_instances.find(type_key);
+        if (instance_it != std::cend(container->reference_counting_instances))
+        {
+            SharedPtr<void> instance = instance_it->second.lock();
+            if (instance != nullptr)
+            {
+                return { instance.get(), std::move(instance), nullptr };
+            }
+        }
+        return {};
+    }
+
+    template<>
+    internal::InstancePtr Container::ResolveInstance<LifeTimeScope::NotControlled>(Container* container, const internal::TypeKey& type_key, const internal::TypeRecord& type_record, const internal::Arguments& arguments)
+    {
+        internal::InstancePtr instance { container->Create(type_key, type_record, arguments), nullptr, type_record.deleter };
+        if (container->tracer != nullptr)
+        {
+            // Only deletion made by container or by shared pointer is traced, unique and raw pointers are deleted by caller
+            instance.traced_deleter = std::make_shared<const internal::TracedDeleter>(
+                    internal::TracedDeleter{ container->tracer, type_key, type_record.interface_name, type_record.lifetime, type_record.deleter });
+        }
+        return instance;
+    }
+
+    template<>
+    internal::InstancePtr Container::ResolveInstance<LifeTimeScope::Singleton>(Container* container, const internal::TypeKey& type_key, const internal::TypeRecord& type_record, const internal::Arguments& arguments)
+    {
+        SharedPtr<void> instance = container->CreateShared(type_key, type_record, arguments);
+        if (container->profile_recorder != nullptr)
+        {
+            container->profile_recorder->EndConstruction(type_key);
+        }
+        container->singleton_instances.emplace(type_key, instance);
+        return { instance.get(), std::move(instance), nullptr };
+    }
+
+    template<>
+    internal::InstancePtr Container::ResolveInstance<LifeTimeScope::ReferenceCounting>(Container* container, const internal::TypeKey& type_key, const internal::TypeRecord& type_record, const internal::Arguments& arguments)
+    {
+        SharedPtr<void> instance = container->CreateShared(type_key, type_record, arguments);
+        container->reference_counting_instances.insert_or_assign(type_key, instance);
+        return { instance.get(), std::move(instance), nullptr };
+    }
+
+    internal::InstancePtr Container::ResolveAlias(Container* container, const internal::TypeKey& type_key, const internal::TypeRecord& type_record, const internal::Arguments& arguments)
+    {
+        void* pointer = type_record.create(container, type_key, arguments);
+        SharedPtr<void> instance(arguments[0].owner, pointer);
+        if (type_record.lifetime == LifeTimeScope::Singleton)
+        {
+            if (container->profile_recorder != nullptr)
+            {
+                container->profile_recorder->EndConstruction(type_key);
+            }
+            container->singleton_instances.emplace(type_key, instance);
         }
         else
         {
-            return type_record.create(this, type_key);
+            container->reference_counting_instances.insert_or_assign(type_key, instance);
+        }
+        return { pointer, std::move(instance), nullptr };
+    }
+
+    Container::Container(const Container& other)
+    : type_registry(other.type_registry),
+      interface_registry(other.interface_registry),
+      shared_overrides(other.shared_overrides),
+      singleton_instances(other.singleton_instances),
+      reference_counting_instances(other.reference_counting_instances),
+      tracer(other.tracer),
+      construction_timing(other.construction_timing),
+      built_singleton_lookup(other.built_singleton_lookup),
+      construction_stats(other.construction_stats),
+      memory_counters(other.memory_counters),
+      profile_recorder(other.profile_recorder != nullptr ? std::make_unique<internal::ProfileRecorder>(*other.profile_recorder) : nullptr)
+    {
+    }
+
+    Container& Container::operator=(const Container& other)
+    {
+        if (this != &other)
+        {
+            *this = Container(other);
         }
+        return *this;
+    }
+
+    Container Container::Fork() const
+    {
+        Container fork;
+        fork.type_registry = type_registry;
+        fork.interface_registry = interface_registry;
+        fork.tracer = tracer;
+        fork.construction_timing = construction_timing;
+        fork.built_singleton_lookup = built_singleton_lookup;
+        return fork;
+    }
+
+    void Container::SetTracer(std::shared_ptr<Tracer> tracer)
+    {
+        this->tracer = std::move(tracer);
+    }
+
+    internal::InstancePtr Container::ResolveModule(Container* container, const internal::TypeKey& type_key, const internal::TypeRecord& type_record)
+    {
+        container->LoadModule(type_record.module);
+        return container->Resolve(type_key);
+    }
+
+    void Container::SetConstructionTiming(bool enabled)
+    {
+        construction_timing = enabled;
+    }
+
+    void Container::SetBuiltSingletonLookup(bool enabled)
+    {
+        built_singleton_lookup = enabled;
     }
 
     std::string_view Container::GetOverride(const internal::TypeKey& interface, TypeId dependency) {
-        auto type_record_it = type_registry.find(interface);
-        if (type_record_it == std::cend(type_registry)) return "";
+        const internal::Registration* registration = type_registry.Find(interface);
+        if (registration == nullptr) return "";
 
-        internal::TypeRecord& type_record = type_record_it->second;
-        auto override_it = type_record.overrides.find(dependency);
-        if (override_it == std::cend(type_record.overrides)) return "";
+        const internal::TypeRecord& type_record = registration->second;
+        auto override_it = type_record.overrides->find(dependency);
+        if (override_it == std::cend(*type_record.overrides)) return "";
         else return override_it->second;
     }
 
-    void Container::CheckWrapperType(internal::WrapperType wrapper_type, const internal::TypeKey &interface)
+    bool Container::AddRecord(const internal::TypeKey& type_key, internal::TypeRecord type_record)
+    {
+        type_record.loaded_module = loading_module;
+        auto& chunk = type_registry.GetMutableChunk(type_registry.GetChunkIndex(type_key));
+        auto [type_record_it, inserted] = chunk.try_emplace(type_key, std::move(type_record));
+        if (inserted)
+        {
+            interface_registry.GetMutableChunk(interface_registry.GetChunkIndex(type_key.type_id))[type_key.type_id].push_back(type_key.type_name);
+            return true;
+        }
+
+        // Module replaces its placeholders when it is loaded
+        if (loading_module != nullptr && type_record_it->second.module == loading_module)
+        {
+            type_record_it->second = std::move(type_record);
+            return true;
+        }
+        return false;
+    }
+
+    bool Container::CanAddRecord(const internal::TypeKey& type_key) const
+    {
+        const internal::Registration* registration = type_registry.Find(type_key);
+        return registration == nullptr || (loading_module != nullptr && registration->second.module == loading_module);
+    }
+
+    bool Container::RemoveRecord(const internal::TypeKey& type_key)
+    {
+        if (type_registry.Find(type_key) == nullptr)
+        {
+            return false;
+        }
+
+        type_registry.GetMutableChunk(type_registry.GetChunkIndex(type_key)).erase(type_key);
+        std::vector<std::string>& names = interface_registry.GetMutableChunk(interface_registry.GetChunkIndex(type_key.type_id))[type_key.type_id];
+        names.erase(std::find(std::begin(names), std::end(names), type_key.type_name));
+        singleton_instances.erase(type_key);
+        reference_counting_instances.erase(type_key);
+        return true;
+    }
+
+    std::shared_ptr<const Overrides> Container::ShareOverrides(const Overrides& overrides)
+    {
+        auto overrides_it = shared_overrides.find(overrides);
+        if (overrides_it == std::cend(shared_overrides))
+        {
+            overrides_it = shared_overrides.insert(std::make_shared<const Overrides>(overrides)).first;
+        }
+        return *overrides_it;
+    }
+
+    std::shared_ptr<const Overrides> Container::InternOverrides(const std::shared_ptr<const Overrides>& overrides)
+    {
+        if (overrides == nullptr)
+        {
+            return ShareOverrides(Overrides{});
+        }
+
+        // Overrides which are not shared yet are stored without copy
+        return *shared_overrides.insert(overrides).first;
+    }
+
+    std::vector<size_t> Container::RegisterBatch(const BatchRegistration* registrations, size_t count)
+    {
+        // Registrations are sorted by chunk and key, so each chunk is changed once
+        // and each insertion is made next to the previous one
+        std::vector<std::pair<size_t, size_t>> order;
+        order.reserve(count);
+        for (size_t index = 0; index < count; ++index)
+        {
+            order.emplace_back(type_registry.GetChunkIndex(registrations[index].type_key), index);
+        }
+        std::stable_sort(std::begin(order), std::end(order), [registrations](const auto& left, const auto& right)
+        {
+            if (left.first != right.first) return left.first < right.first;
+            return registrations[left.second].type_key < registrations[right.second].type_key;
+        });
+
+        // Registrations made with the same overrides share them after one lookup
+        std::map<const Overrides*, std::shared_ptr<const Overrides>> batch_overrides;
+        std::vector<size_t> rejected;
+        std::vector<bool> added(count, false);
+        const internal::TypeKey* previous_key = nullptr;
+        std::map<internal::TypeKey, internal::TypeRecord>* chunk = nullptr;
+        size_t chunk_index = 0;
+        std::map<internal::TypeKey, internal::TypeRecord>::iterator position;
+        for (auto [index_chunk, index] : order)
+        {
+            const BatchRegistration& registration = registrations[index];
+            if (chunk == nullptr || chunk_index != index_chunk)
+            {
+                chunk_index = index_chunk;
+                chunk = &type_registry.GetMutableChunk(chunk_index);
+                position = std::begin(*chunk);
+                previous_key = nullptr;
+            }
+
+            if (previous_key != nullptr && !(*previous_key < registration.type_key))
+            {
+                rejected.push_back(index);
+                continue;
+            }
+            previous_key = &registration.type_key;
+
+            if (position != std::end(*chunk) && position->first < registration.type_key)
+            {
+                position = chunk->lower_bound(registration.type_key);
+            }
+
+            internal::TypeRecord type_record = registration.type_record;
+            auto [overrides_it, inserted] = batch_overrides.try_emplace(registration.overrides.get());
+            if (inserted)
+            {
+                overrides_it->second = InternOverrides(registration.overrides);
+            }
+            type_record.overrides = overrides_it->second;
+            type_record.loaded_module = loading_module;
+            if (position != std::end(*chunk) && !(registration.type_key < position->first))
+            {
+                // Module replaces its placeholders when it is loaded
+                if (loading_module == nullptr || position->second.module != loading_module)
+                {
+                    rejected.push_back(index);
+                    continue;
+                }
+                position->second = std::move(type_record);
+                ++position;
+                continue;
+            }
+
+            position = std::next(chunk->emplace_hint(position, registration.type_key, std::move(type_record)));
+            added[index] = true;
+        }
+
+        // Collections are resolved in order of registration
+        std::map<TypeId, size_t> added_names;
+        for (size_t index = 0; index < count; ++index)
+        {
+            if (added[index]) added_names[registrations[index].type_key.type_id]++;
+        }
+        for (const auto& [type_id, names] : added_names)
+        {
+            std::vector<std::string>& interface_names = interface_registry.GetMutableChunk(interface_registry.GetChunkIndex(type_id))[type_id];
+            interface_names.reserve(interface_names.size() + names);
+        }
+        for (size_t index = 0; index < count; ++index)
+        {
+            if (!added[index]) continue;
+
+            const TypeId type_id = registrations[index].type_key.type_id;
+            interface_registry.GetMutableChunk(interface_registry.GetChunkIndex(type_id))[type_id].push_back(registrations[index].type_key.type_name);
+        }
+
+        std::sort(std::begin(rejected), std::end(rejected));
+        return rejected;
+    }
+
+    const internal::Registration& Container::CheckWrapperType(internal::WrapperType wrapper_type, const internal::TypeKey &interface)
     {
         using internal::WrapperType;
-        auto type_record_it = type_registry.find(interface);
-        if (type_record_it == std::cend(type_registry))
+        auto lock = LockConcurrentAccess();
+        const internal::Registration* registration = type_registry.Find(interface);
+        if (registration == nullptr)
         {
             throw SDILException("Type is not registered. Use " TO_STRING(Container::Register) " to register the type");
         }
 
-        internal::TypeRecord& type_record = type_record_it->second;
+        if (registration->second.module != nullptr)
+        {
+            LoadModule(registration->second.module);
+            registration = type_registry.Find(interface);
+        }
+
+        const internal::TypeRecord& type_record = registration->second;
         switch (type_record.lifetime) {
             case LifeTimeScope::Singleton:
                 if (wrapper_type == WrapperType::Unique)
@@ -118,5 +868,23 @@ namespace sdil
                 }
                 break;
         }
+        return *registration;
+    }
+
+    void Container::CheckFactoryType(const internal::TypeKey& type_key, std::string_view type_name)
+    {
+        auto lock = LockConcurrentAccess();
+        const internal::Registration* registration = type_registry.Find(type_key);
+        if (registration != nullptr && registration->second.module != nullptr)
+        {
+            LoadModule(registration->second.module);
+            registration = type_registry.Find(type_key);
+        }
+
+        if (registration != nullptr && registration->second.implementation_name != type_name)
+        {
+            throw SDILException("Factory creates " + std::string(type_name) + ", but " + internal::ToString(type_key, registration->second)
+                    + " is registered as " + std::string(registration->second.implementation_name));
+        }
     }
 }
@@ -0,0 +1,251 @@
+#include "SDIL_graph.hpp"
+
+namespace sdil
+{
+    namespace
+    {
+        std::chrono::nanoseconds GetConstructionCost(const DependencyGraph::Node& node)
+        {
+            if (node.constructions == 0) return {};
+            return node.construction_time / node.constructions;
+        }
+
+        std::string GetNodeName(const DependencyGraph::Node& node)
+        {
+            std::string name { node.interface_name };
+            if (!node.type_name.empty())
+            {
+                name += "[" + node.type_name + "]";
+            }
+            return name;
+        }
+
+        void FindCriticalPath(DependencyGraph& graph)
+        {
+            enum class State { NotVisited, InProgress, Visited };
+
+            const size_t nodes_count = graph.nodes.size();
+            std::vector<std::vector<size_t>> adjacency(nodes_count);
+            for (const DependencyGraph::Edge& edge : graph.edges)
+            {
+                adjacency[edge.from].push_back(edge.to);
+            }
+
+            constexpr size_t no_node = static_cast<size_t>(-1);
+            std::vector<State> states(nodes_count, State::NotVisited);
+            std::vector<std::chrono::nanoseconds> path_times(nodes_count);
+            std::vector<size_t> next_nodes(nodes_count, no_node);
+
+            // Depth first search with explicit stack, edges closing a cycle are ignored
+            std::vector<std::pair<size_t, size_t>> stack;
+            for (size_t root = 0; root < nodes_count; ++root)
+            {
+                if (states[root] != State::NotVisited) continue;
+
+                states[root] = State::InProgress;
+                stack.emplace_back(root, 0);
+                while (!stack.empty())
+                {
+                    auto [node, child_index] = stack.back();
+                    if (child_index < adjacency[node].size())
+                    {
+                        stack.back().second++;
+                        const size_t child = adjacency[node][child_index];
+                        if (states[child] == State::NotVisited)
+                        {
+                            states[child] = State::InProgress;
+                            stack.emplace_back(child, 0);
+                        }
+                        continue;
+                    }
+
+                    const auto cost = GetConstructionCost(graph.nodes[node]);
+                    path_times[node] = cost;
+                    for (size_t child : adjacency[node])
+                    {
+                        if (states[child] == State::Visited && cost + path_times[child] > path_times[node])
+                        {
+                            path_times[node] = cost + path_times[child];
+                            next_nodes[node] = child;
+                        }
+                    }
+                    states[node] = State::Visited;
+                    stack.pop_back();
+                }
+            }
+
+            if (nodes_count == 0) return;
+
+            size_t node = 0;
+            for (size_t candidate = 1; candidate < nodes_count; ++candidate)
+            {
+                if (path_times[candidate] > path_times[node]) node = candidate;
+            }
+
+            graph.critical_path_time = path_times[node];
+            for (; node != no_node; node = next_nodes[node])
+            {
+                graph.critical_path.push_back(node);
+            }
+        }
+    }
+
+    DependencyGraph Container::GetDependencyGraph() const
+    {
+        DependencyGraph graph;
+        std::map<internal::TypeKey, size_t> node_indices;
+
+        auto add_node = [&](const internal::TypeKey& type_key, std::string_view interface_name)
+        {
+            auto [node_it, inserted] = node_indices.emplace(type_key, graph.nodes.size());
+            if (!inserted) return node_it->second;
+
+            DependencyGraph::Node node { type_key.type_id, interface_name, type_key.type_name, {}, LifeTimeScope::NotControlled, false, 0, {} };
+            const internal::Registration* registration = type_registry.Find(type_key);
+            if (registration != nullptr)
+            {
+                node.implementation_name = registration->second.implementation_name;
+                node.lifetime = registration->second.lifetime;
+                node.registered = true;
+            }
+
+            auto stats_it = construction_stats.find(type_key);
+            if (stats_it != std::cend(construction_stats))
+            {
+                node.constructions = stats_it->second.constructions;
+                node.construction_time = stats_it->second.construction_time;
+            }
+
+            graph.nodes.push_back(std::move(node));
+            return node_it->second;
+        };
+
+        type_registry.ForEach([&](const internal::Registration& registration)
+        {
+            add_node(registration.first, registration.second.interface_name);
+        });
+
+        type_registry.ForEach([&](const internal::Registration& registration)
+        {
+            const auto& [type_key, type_record] = registration;
+            const size_t from = node_indices[type_key];
+            for (const internal::Dependency& dependency : *type_record.dependencies)
+            {
+                using internal::WrapperType;
+                if (dependency.wrapper_type == WrapperType::None) continue;
+
+                if (dependency.wrapper_type == WrapperType::Collection)
+                {
+                    const auto* interface_it = interface_registry.Find(dependency.type_id);
+                    if (interface_it == nullptr) continue;
+
+                    for (const std::string& name : interface_it->second)
+                    {
+                        const size_t to = add_node(internal::TypeKey{ dependency.type_id, name }, dependency.interface_name);
+                        graph.edges.push_back({ from, to, dependency.wrapper_type, false });
+                    }
+                    continue;
+                }
+
+                auto override_it = type_record.overrides->find(dependency.type_id);
+                const bool overridden = override_it != std::cend(*type_record.overrides);
+                const internal::TypeKey dependency_key { dependency.type_id, overridden ? override_it->second : "" };
+                graph.edges.push_back({ from, add_node(dependency_key, dependency.interface_name), dependency.wrapper_type, overridden });
+            }
+        });
+
+        FindCriticalPath(graph);
+        return graph;
+    }
+
+    void DependencyGraph::WriteDot(std::ostream& output) const
+    {
+        constexpr size_t no_node = static_cast<size_t>(-1);
+        std::vector<bool> critical_nodes(nodes.size());
+        std::vector<size_t> critical_next_nodes(nodes.size(), no_node);
+        for (size_t index = 0; index < critical_path.size(); ++index)
+        {
+            critical_nodes[critical_path[index]] = true;
+            if (index + 1 < critical_path.size())
+            {
+                critical_next_nodes[critical_path[index]] = critical_path[index + 1];
+            }
+        }
+
+        output << "digraph SDIL {\n";
+        output << "    node [shape=box];\n";
+        for (size_t index = 0; index < nodes.size(); ++index)
+        {
+            const Node& node = nodes[index];
+            std::string label = GetNodeName(node);
+            if (node.registered)
+            {
+                label += "\n" + std::string(node.implementation_name) + "\n" + internal::ToString(node.lifetime);
+                if (node.constructions != 0)
+                {
+                    label += "\n" + std::to_string(GetConstructionCost(node).count()) + " ns x " + std::to_string(node.constructions);
+                }
+            }
+            else
+            {
+                label += "\nnot registered";
+            }
+
+            output << "    n" << index << " [label=";
+            internal::WriteJsonString(output, label);
+            if (!node.registered) output << ", style=dashed";
+            if (critical_nodes[index]) output << ", color=red, penwidth=2";
+            output << "];\n";
+        }
+
+        for (const Edge& edge : edges)
+        {
+            const bool critical_edge = critical_next_nodes[edge.from] == edge.to;
+            output << "    n" << edge.from << " -> n" << edge.to << " [label=\"" << internal::ToString(edge.wrapper_type);
+            if (edge.overridden) output << " (override)";
+            output << "\"";
+            if (critical_edge) output << ", color=red, penwidth=2";
+            output << "];\n";
+        }
+        output << "}\n";
+    }
+
+    void DependencyGraph::WriteJson(std::ostream& output) const
+    {
+        output << "{\"nodes\":[";
+        for (size_t index = 0; index < nodes.size(); ++index)
+        {
+            const Node& node = nodes[index];
+            output << (index == 0 ? "\n" : ",\n") << "{\"id\":" << index << ",\"type\":";
+            internal::WriteJsonString(output, node.interface_name);
+            output << ",\"type_id\":\"0x" << std::hex << node.type_id << std::dec << "\",\"name\":";
+            internal::WriteJsonString(output, node.type_name);
+            output << ",\"registered\":" << (node.registered ? "true" : "false");
+            if (node.registered)
+            {
+                output << ",\"implementation\":";
+                internal::WriteJsonString(output, node.implementation_name);
+                output << ",\"lifetime\":\"" << internal::ToString(node.lifetime) << "\"";
+            }
+            output << ",\"constructions\":" << node.constructions
+                   << ",\"construction_time_ns\":" << node.construction_time.count() << "}";
+        }
+
+        output << "\n],\"edges\":[";
+        for (size_t index = 0; index < edges.size(); ++index)
+        {
+            const Edge& edge = edges[index];
+            output << (index == 0 ? "\n" : ",\n")
+                   << "{\"from\":" << edge.from << ",\"to\":" << edge.to
+                   << ",\"wrapper\":\"" << internal::ToString(edge.wrapper_type) << "\""
+                   << ",\"override\":" << (edge.overridden ? "true" : "false") << "}";
+        }
+
+        output << "\n],\"critical_path\":{\"time_ns\":" << critical_path_time.count() << ",\"nodes\":[";
+        for (size_t index = 0; index < critical_path.size(); ++index)
+        {
+            output << (index == 0 ? "" : ",") << critical_path[index];
+        }
+        output << "]}}\n";
+    }
+}
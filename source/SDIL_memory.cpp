@@ -0,0 +1,125 @@
+#include "SDIL_memory.hpp"
+
+#include <new>
+
+namespace sdil
+{
+    namespace
+    {
+        /// Stored before every MemoryTracked instance, keeps counter alive while instance is
+        struct AllocationHeader
+        {
+            std::shared_ptr<internal::MemoryCounter> counter;
+            size_t size;
+        };
+
+        constexpr size_t HeaderSize = (sizeof(AllocationHeader) + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+
+        thread_local const std::shared_ptr<internal::MemoryCounter>* current_counter = nullptr;
+
+        /// Accounts allocation to current counter, returns memory of instance placed after header
+        void* Track(void* memory, size_t size) noexcept
+        {
+            auto header = new (memory) AllocationHeader{ current_counter != nullptr ? *current_counter : nullptr, size };
+            if (header->counter != nullptr)
+            {
+                header->counter->Allocate(size);
+            }
+            return static_cast<char*>(memory) + HeaderSize;
+        }
+    }
+
+    void* MemoryTracked::operator new(size_t size)
+    {
+        return Track(::operator new(HeaderSize + size), size);
+    }
+
+    void* MemoryTracked::operator new(size_t size, const std::nothrow_t&) noexcept
+    {
+        void* memory = ::operator new(HeaderSize + size, std::nothrow);
+        if (memory == nullptr)
+        {
+            return nullptr;
+        }
+        return Track(memory, size);
+    }
+
+    void MemoryTracked::operator delete(void* pointer, const std::nothrow_t&) noexcept
+    {
+        operator delete(pointer);
+    }
+
+    void MemoryTracked::operator delete(void* pointer)
+    {
+        if (pointer == nullptr)
+        {
+            return;
+        }
+
+        void* memory = static_cast<char*>(pointer) - HeaderSize;
+        auto header = static_cast<AllocationHeader*>(memory);
+        if (header->counter != nullptr)
+        {
+            header->counter->Deallocate(header->size);
+        }
+        header->~AllocationHeader();
+        ::operator delete(memory);
+    }
+
+    namespace internal
+    {
+        void MemoryCounter::Allocate(size_t size)
+        {
+            live_instances++;
+            allocations++;
+            const size_t bytes = live_bytes += size;
+            size_t peak = peak_bytes.load(std::memory_order_relaxed);
+            while (peak < bytes && !peak_bytes.compare_exchange_weak(peak, bytes, std::memory_order_relaxed))
+            {
+            }
+        }
+
+        void MemoryCounter::Deallocate(size_t size)
+        {
+            live_instances--;
+            live_bytes -= size;
+        }
+
+        MemoryStats MemoryCounter::GetStats() const
+        {
+            return MemoryStats{ live_instances, live_bytes, peak_bytes, allocations };
+        }
+
+        void MemoryScope::Enter()
+        {
+            previous = current_counter;
+            current_counter = &counter;
+        }
+
+        void MemoryScope::Leave()
+        {
+            current_counter = previous;
+        }
+    }
+
+    std::shared_ptr<internal::MemoryCounter> Container::GetMemoryCounter(const internal::TypeKey& type_key)
+    {
+        auto lock = LockConcurrentAccess();
+        std::shared_ptr<internal::MemoryCounter>& counter = memory_counters[type_key];
+        if (counter == nullptr)
+        {
+            counter = std::make_shared<internal::MemoryCounter>();
+        }
+        return counter;
+    }
+
+    MemoryStats Container::GetMemoryStats(const internal::TypeKey& type_key) const
+    {
+        auto counter_it = memory_counters.find(type_key);
+        if (counter_it == std::cend(memory_counters))
+        {
+            return {};
+        }
+        return counter_it->second->GetStats();
+    }
+}
@@ -0,0 +1,102 @@
+#include "SDIL.hpp"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
+
+namespace sdil
+{
+    namespace
+    {
+        using RegisterModuleFunction = void(Container&);
+
+        /// Loads library and finds its registration function. Library is never unloaded,
+        /// because instances, factories and deleters registered by module refer to its code.
+        RegisterModuleFunction* LoadRegisterModuleFunction(const std::string& library_path)
+        {
+#if defined(_WIN32)
+            HMODULE library = LoadLibraryA(library_path.c_str());
+            if (library == nullptr)
+            {
+                throw SDILException("Module library can not be loaded: " + library_path + ", error " + std::to_string(GetLastError()));
+            }
+            auto function = reinterpret_cast<RegisterModuleFunction*>(GetProcAddress(library, "SDILRegisterModule"));
+#else
+            void* library = dlopen(library_path.c_str(), RTLD_NOW | RTLD_LOCAL);
+            if (library == nullptr)
+            {
+                throw SDILException("Module library can not be loaded: " + std::string(dlerror()));
+            }
+            auto function = reinterpret_cast<RegisterModuleFunction*>(dlsym(library, "SDILRegisterModule"));
+#endif
+            if (function == nullptr)
+            {
+                throw SDILException("Module library does not define SDIL_REGISTER_MODULE: " + library_path);
+            }
+            return function;
+        }
+    }
+
+    bool Container::RegisterModule(const ModuleManifest& manifest)
+    {
+        for (const internal::ModuleType& type : manifest.types)
+        {
+            if (type_registry.Find(internal::TypeKey{ type.type_id, type.type_name }) != nullptr)
+            {
+                return false;
+            }
+        }
+
+        static const std::vector<internal::Dependency> no_dependencies;
+        auto module = std::make_shared<const internal::Module>(internal::Module{ manifest.library_path, manifest.types });
+        for (const internal::ModuleType& type : module->types)
+        {
+            internal::TypeRecord type_record {
+                LifeTimeScope::NotControlled,
+                type.interface_name,
+                module->library_path,
+                ShareOverrides({}),
+                nullptr,
+                nullptr,
+                &ResolveModule,
+                nullptr,
+                &no_dependencies,
+                module,
+                nullptr,
+                false
+            };
+            AddRecord(internal::TypeKey{ type.type_id, type.type_name }, std::move(type_record));
+        }
+        return true;
+    }
+
+    void Container::LoadModule(std::shared_ptr<const internal::Module> module)
+    {
+        auto lock = LockConcurrentAccess();
+        RegisterModuleFunction* register_module = LoadRegisterModuleFunction(module->library_path);
+
+        loading_module = module;
+        try
+        {
+            register_module(*this);
+        }
+        catch (...)
+        {
+            loading_module = nullptr;
+            throw;
+        }
+        loading_module = nullptr;
+
+        for (const internal::ModuleType& type : module->types)
+        {
+            const internal::Registration* registration = type_registry.Find(internal::TypeKey{ type.type_id, type.type_name });
+            if (registration == nullptr || registration->second.module == module)
+            {
+                throw SDILException("Module " + module->library_path + " has not registered declared type "
+                        + std::string(type.interface_name) + "[" + type.type_name + "]");
+            }
+        }
+    }
+}
@@ -0,0 +1,438 @@
+#include "SDIL.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <iterator>
+#include <thread>
+
+namespace sdil
+{
+    namespace
+    {
+        constexpr std::string_view ProfileMagic = "SDILPROF";
+        constexpr uint64_t ProfileVersion = 2;
+        /// Type of interface name which is shared by several types, such interface can not be replayed
+        constexpr TypeId AmbiguousTypeId = 0;
+
+        void WriteVarint(std::string& output, uint64_t value)
+        {
+            while (value >= 0x80)
+            {
+                output.push_back(static_cast<char>(value | 0x80));
+                value >>= 7;
+            }
+            output.push_back(static_cast<char>(value));
+        }
+
+        void WriteFixed(std::string& output, uint64_t value)
+        {
+            for (size_t byte = 0; byte < sizeof(value); ++byte)
+            {
+                output.push_back(static_cast<char>(value >> (8 * byte)));
+            }
+        }
+
+        /// Reads values written by WriteVarint and WriteFixed, fails instead of reading beyond data
+        class ProfileReader
+        {
+        public:
+            explicit ProfileReader(std::string_view data) : data(data) { }
+
+            bool ReadVarint(uint64_t& value)
+            {
+                value = 0;
+                for (size_t shift = 0; shift < 64; shift += 7)
+                {
+                    if (position == data.size()) return false;
+
+                    const auto byte = static_cast<unsigned char>(data[position++]);
+                    value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                    if ((byte & 0x80) == 0) return true;
+                }
+                return false;
+            }
+
+            bool ReadFixed(uint64_t& value)
+            {
+                if (data.size() - position < sizeof(value)) return false;
+
+                value = 0;
+                for (size_t byte = 0; byte < sizeof(value); ++byte)
+                {
+                    value |= static_cast<uint64_t>(static_cast<unsigned char>(data[position++])) << (8 * byte);
+                }
+                return true;
+            }
+
+            bool ReadBytes(uint64_t size, std::string_view& bytes)
+            {
+                if (data.size() - position < size) return false;
+
+                bytes = data.substr(position, static_cast<size_t>(size));
+                position += static_cast<size_t>(size);
+                return true;
+            }
+
+            bool AtEnd() const { return position == data.size(); }
+
+        private:
+            std::string_view data;
+            size_t position = 0;
+        };
+    }
+
+    namespace internal
+    {
+        void ProfileRecorder::BeginConstruction()
+        {
+            frames.emplace_back();
+        }
+
+        void ProfileRecorder::EndConstruction(const TypeKey& type_key)
+        {
+            const auto index = static_cast<uint32_t>(entries.size());
+            entries.push_back({ type_key, std::move(frames.back()) });
+            frames.pop_back();
+
+            indices.emplace(type_key, index);
+            if (!frames.empty())
+            {
+                frames.back().push_back(index);
+            }
+        }
+
+        void ProfileRecorder::AbortConstruction()
+        {
+            frames.pop_back();
+        }
+
+        void ProfileRecorder::AddDependency(const TypeKey& type_key)
+        {
+            if (frames.empty()) return;
+
+            auto index_it = indices.find(type_key);
+            if (index_it != std::cend(indices))
+            {
+                frames.back().push_back(index_it->second);
+            }
+        }
+    }
+
+    uint64_t Container::GetRegistryFingerprint() const
+    {
+        uint64_t fingerprint = internal::Hash("");
+        auto add = [&fingerprint](std::string_view value)
+        {
+            fingerprint = internal::Hash(value, fingerprint);
+            fingerprint = internal::Hash(std::string_view("", 1), fingerprint);
+        };
+
+        // Module is described by its manifest, since its types are placeholders until it is loaded
+        std::set<std::string> modules;
+        type_registry.ForEach([&add, &modules](const internal::Registration& registration)
+        {
+            const auto& [type_key, type_record] = registration;
+            const internal::Module* module = type_record.module != nullptr ? type_record.module.get() : type_record.loaded_module.get();
+            if (module != nullptr)
+            {
+                std::string manifest = module->library_path;
+                for (const internal::ModuleType& type : module->types)
+                {
+                    manifest.push_back('\0');
+                    manifest += type.interface_name;
+                    manifest.push_back('\0');
+                    manifest += type.type_name;
+                }
+                modules.insert(std::move(manifest));
+                return;
+            }
+
+            add(type_record.interface_name);
+            add(type_key.type_name);
+            add(type_record.implementation_name);
+            add(internal::ToString(type_record.lifetime));
+
+            // Dependencies are described by names, since identifiers of types local to translation unit differ between runs
+            for (const internal::Dependency& dependency : *type_record.dependencies)
+            {
+                add(dependency.interface_name);
+                add(internal::ToString(dependency.wrapper_type));
+                auto override_it = type_record.overrides->find(dependency.type_id);
+                add(override_it == std::cend(*type_record.overrides) ? std::string_view("", 1) : override_it->second);
+            }
+            add(std::to_string(type_record.dependencies->size()));
+        });
+        for (const std::string& manifest : modules)
+        {
+            add(manifest);
+        }
+        return fingerprint;
+    }
+
+    void Container::StartProfileRecording()
+    {
+        profile_recorder = std::make_unique<internal::ProfileRecorder>();
+    }
+
+    bool Container::StopProfileRecording(const std::string& path)
+    {
+        std::unique_ptr<internal::ProfileRecorder> recorder = std::move(profile_recorder);
+        if (recorder == nullptr || recorder->entries.empty())
+        {
+            return false;
+        }
+
+        std::string data { ProfileMagic };
+        WriteVarint(data, ProfileVersion);
+        WriteFixed(data, GetRegistryFingerprint());
+        WriteVarint(data, recorder->entries.size());
+        for (size_t index = 0; index < recorder->entries.size(); ++index)
+        {
+            internal::ProfileRecorder::Entry& entry = recorder->entries[index];
+            const internal::Registration* registration = type_registry.Find(entry.type_key);
+            if (registration == nullptr)
+            {
+                return false;
+            }
+
+            // Interface is saved by hash of its name, since identifiers of types local to translation unit differ between runs
+            WriteFixed(data, internal::Hash(registration->second.interface_name));
+            WriteVarint(data, entry.type_key.type_name.size());
+            data += entry.type_key.type_name;
+
+            // Dependencies are recorded before dependent construction, so they are stored as distance back
+            std::sort(std::begin(entry.dependencies), std::end(entry.dependencies));
+            entry.dependencies.erase(std::unique(std::begin(entry.dependencies), std::end(entry.dependencies)), std::end(entry.dependencies));
+            WriteVarint(data, entry.dependencies.size());
+            for (uint32_t dependency : entry.dependencies)
+            {
+                WriteVarint(data, index - dependency);
+            }
+        }
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(data.data(), static_cast<std::streamsize>(data.size()));
+        return static_cast<bool>(file);
+    }
+
+    bool Container::ReplayProfile(const std::string& path, size_t threads)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+        {
+            return false;
+        }
+        const std::string data { std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+
+        ProfileReader reader(data);
+        std::string_view magic;
+        uint64_t version = 0, fingerprint = 0, entries_count = 0;
+        if (!reader.ReadBytes(ProfileMagic.size(), magic) || magic != ProfileMagic
+            || !reader.ReadVarint(version) || version != ProfileVersion
+            || !reader.ReadFixed(fingerprint) || fingerprint != GetRegistryFingerprint()
+            || !reader.ReadVarint(entries_count) || entries_count > data.size())
+        {
+            return false;
+        }
+
+        struct Construction
+        {
+            internal::TypeKey type_key;
+            const internal::TypeRecord* type_record;
+            size_t level;
+        };
+
+        std::map<uint64_t, TypeId> type_ids;
+        type_registry.ForEach([&type_ids](const internal::Registration& registration)
+        {
+            const auto& [type_key, type_record] = registration;
+            auto [type_id_it, inserted] = type_ids.emplace(internal::Hash(type_record.interface_name), type_key.type_id);
+            if (!inserted && type_id_it->second != type_key.type_id)
+            {
+                type_id_it->second = AmbiguousTypeId;
+            }
+        });
+
+        std::vector<Construction> constructions;
+        constructions.reserve(static_cast<size_t>(entries_count));
+        size_t levels_count = 0;
+        for (size_t index = 0; index < entries_count; ++index)
+        {
+            uint64_t interface_hash = 0, name_size = 0, dependencies_count = 0;
+            std::string_view name;
+            if (!reader.ReadFixed(interface_hash) || !reader.ReadVarint(name_size) || !reader.ReadBytes(name_size, name))
+            {
+                return false;
+            }
+
+            auto type_id_it = type_ids.find(interface_hash);
+            if (type_id_it == std::cend(type_ids) || type_id_it->second == AmbiguousTypeId)
+            {
+                return false;
+            }
+            internal::TypeKey type_key { type_id_it->second, std::string(name) };
+            const internal::Registration* registration = type_registry.Find(type_key);
+            if (registration != nullptr && registration->second.module != nullptr)
+            {
+                // Module loaded by recorded run is loaded before its types are replayed
+                try
+                {
+                    LoadModule(registration->second.module);
+                }
+                catch (...)
+                {
+                    // Module which can not be loaded is reported when its type is resolved
+                }
+                registration = type_registry.Find(type_key);
+            }
+            if (registration == nullptr || (registration->second.module == nullptr && registration->second.lifetime != LifeTimeScope::Singleton))
+            {
+                return false;
+            }
+
+            // Construction is made after all its dependencies are made on previous levels
+            size_t level = 0;
+            if (!reader.ReadVarint(dependencies_count) || dependencies_count > index)
+            {
+                return false;
+            }
+            for (size_t dependency = 0; dependency < dependencies_count; ++dependency)
+            {
+                uint64_t distance = 0;
+                if (!reader.ReadVarint(distance) || distance == 0 || distance > index)
+                {
+                    return false;
+                }
+                level = std::max(level, constructions[index - static_cast<size_t>(distance)].level + 1);
+            }
+
+            // Type of module which has not been loaded is skipped
+            const internal::TypeRecord* type_record = registration->second.module == nullptr ? &registration->second : nullptr;
+            constructions.push_back({ std::move(type_key), type_record, level });
+            levels_count = std::max(levels_count, level + 1);
+        }
+
+        if (!reader.AtEnd())
+        {
+            return false;
+        }
+
+        std::vector<std::vector<const Construction*>> levels(levels_count);
+        for (Construction& construction : constructions)
+        {
+            if (construction.type_record == nullptr)
+            {
+                continue;
+            }
+
+            // Records are found again, since loaded modules can have changed registry after they were found
+            construction.type_record = &type_registry.Find(construction.type_key)->second;
+            levels[construction.level].push_back(&construction);
+        }
+
+        // Replayed constructions are not a part of recorded run
+        std::unique_ptr<internal::ProfileRecorder> recorder = std::move(profile_recorder);
+        for (const std::vector<const Construction*>& level : levels)
+        {
+            if (threads <= 1 || level.size() == 1)
+            {
+                for (const Construction* construction : level)
+                {
+                    try
+                    {
+                        Resolve(construction->type_key);
+                    }
+                    catch (...)
+                    {
+                        // Failed construction is repeated and reported when instance is resolved
+                    }
+                }
+                continue;
+            }
+
+            // Construction is marked while it is made outside of lock, so singleton needed by another
+            // construction of the level is never made twice. Such construction is repeated after the level
+            std::vector<const Construction*> conflicts;
+            std::atomic<size_t> next_construction { 0 };
+            auto construct = [&]()
+            {
+                for (size_t index = next_construction++; index < level.size(); index = next_construction++)
+                {
+                    const Construction& construction = *level[index];
+                    std::vector<internal::InstancePtr> arguments;
+                    bool marked = false;
+                    try
+                    {
+                        {
+                            auto lock = LockConcurrentAccess();
+                            if (singleton_instances.count(construction.type_key) != 0 || replayed_constructions.count(construction.type_key) != 0)
+                            {
+                                continue;
+                            }
+
+                            // Alias only casts instance of another interface, nothing is constructed
+                            if (construction.type_record->resolve == &ResolveAlias)
+                            {
+                                Resolve(construction.type_key);
+                                continue;
+                            }
+                            marked = replayed_constructions.insert(construction.type_key).second;
+                            ResolveDependencies(construction.type_key, *construction.type_record, arguments);
+                        }
+
+                        SharedPtr<void> instance = CreateShared(construction.type_key, *construction.type_record, internal::Arguments{ &arguments, 0 });
+                        auto lock = LockConcurrentAccess();
+                        singleton_instances.emplace(construction.type_key, std::move(instance));
+                        replayed_constructions.erase(construction.type_key);
+                        marked = false;
+                    }
+                    catch (const internal::ReplayConflict&)
+                    {
+                        auto lock = LockConcurrentAccess();
+                        conflicts.push_back(&construction);
+                    }
+                    catch (...)
+                    {
+                        // Failed construction is repeated and reported when instance is resolved
+                    }
+
+                    if (marked)
+                    {
+                        auto lock = LockConcurrentAccess();
+                        replayed_constructions.erase(construction.type_key);
+                    }
+                    internal::ReleaseArguments(arguments, 0);
+                }
+            };
+
+            concurrent_access = std::make_unique<std::recursive_mutex>();
+            std::vector<std::thread> workers;
+            for (size_t worker = 1; worker < std::min(threads, level.size()); ++worker)
+            {
+                workers.emplace_back(construct);
+            }
+            construct();
+            for (std::thread& worker : workers)
+            {
+                worker.join();
+            }
+            concurrent_access.reset();
+
+            for (const Construction* construction : conflicts)
+            {
+                try
+                {
+                    Resolve(construction->type_key);
+                }
+                catch (...)
+                {
+                    // Failed construction is repeated and reported when instance is resolved
+                }
+            }
+        }
+        profile_recorder = std::move(recorder);
+
+        return true;
+    }
+}
@@ -0,0 +1,131 @@
+#include "SDIL_tracing.hpp"
+
+#include <algorithm>
+#include <atomic>
+
+namespace sdil
+{
+    namespace
+    {
+        struct ThreadBufferCache
+        {
+            uint64_t tracer_id = 0;
+            void* buffer = nullptr;
+        };
+
+        thread_local ThreadBufferCache thread_buffer_cache;
+        std::atomic<uint64_t> next_tracer_id { 1 };
+
+        const char* ToString(internal::SpanKind kind)
+        {
+            switch (kind)
+            {
+                case internal::SpanKind::Resolve: return "resolve";
+                case internal::SpanKind::Create: return "create";
+                case internal::SpanKind::Delete: return "delete";
+            }
+            return "unknown";
+        }
+
+        void WriteMicroseconds(std::ostream& output, std::chrono::nanoseconds time)
+        {
+            const auto fraction = time.count() % 1000;
+            output << time.count() / 1000 << '.' << fraction / 100 << fraction / 10 % 10 << fraction % 10;
+        }
+    }
+
+    Tracer::Tracer()
+    : id(next_tracer_id++), origin(std::chrono::steady_clock::now())
+    {
+    }
+
+    std::chrono::nanoseconds Tracer::Now() const
+    {
+        return std::chrono::steady_clock::now() - origin;
+    }
+
+    void Tracer::Record(internal::Span&& span)
+    {
+        GetThreadBuffer().spans.push_back(std::move(span));
+    }
+
+    Tracer::ThreadBuffer& Tracer::GetThreadBuffer()
+    {
+        if (thread_buffer_cache.tracer_id == id)
+        {
+            return *static_cast<ThreadBuffer*>(thread_buffer_cache.buffer);
+        }
+
+        std::lock_guard lock(mutex);
+        const auto thread_id = std::this_thread::get_id();
+        auto buffer_it = std::find_if(std::begin(buffers), std::end(buffers), [&](auto& buffer) { return buffer->thread_id == thread_id; });
+        if (buffer_it == std::end(buffers))
+        {
+            buffers.push_back(std::make_unique<ThreadBuffer>(ThreadBuffer{ thread_id, buffers.size() + 1, {} }));
+            buffer_it = std::prev(std::end(buffers));
+        }
+
+        thread_buffer_cache = { id, buffer_it->get() };
+        return **buffer_it;
+    }
+
+    namespace internal
+    {
+        void TraceScope::Begin(SpanKind kind, const TypeKey& type_key, std::string_view interface_name, LifeTimeScope lifetime)
+        {
+            span.kind = kind;
+            span.type_id = type_key.type_id;
+            span.interface_name = interface_name;
+            span.type_name = type_key.type_name;
+            span.lifetime = lifetime;
+            span.begin = tracer->Now();
+        }
+
+        void TraceScope::End()
+        {
+            span.end = tracer->Now();
+            tracer->Record(std::move(span));
+        }
+
+        void TracedDeleter::operator()(void* ptr) const
+        {
+            TraceScope trace_scope(tracer.get(), SpanKind::Delete, type_key, interface_name, lifetime);
+            deleter(ptr);
+        }
+    }
+
+    void Tracer::WriteChromeTrace(std::ostream& output) const
+    {
+        std::lock_guard lock(mutex);
+
+        output << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+        bool first = true;
+        for (auto& buffer : buffers)
+        {
+            for (const internal::Span& span : buffer->spans)
+            {
+                output << (first ? "\n" : ",\n");
+                first = false;
+
+                std::string name { span.interface_name };
+                if (!span.type_name.empty())
+                {
+                    name += "[" + span.type_name + "]";
+                }
+
+                output << "{\"name\":";
+                internal::WriteJsonString(output, name);
+                output << ",\"cat\":\"" << ToString(span.kind) << "\",\"ph\":\"X\",\"ts\":";
+                WriteMicroseconds(output, span.begin);
+                output << ",\"dur\":";
+                WriteMicroseconds(output, span.end - span.begin);
+                output << ",\"pid\":1,\"tid\":" << buffer->thread_index << ",\"args\":{\"type\":";
+                internal::WriteJsonString(output, span.interface_name);
+                output << ",\"type_id\":\"0x" << std::hex << span.type_id << std::dec << "\",\"name\":";
+                internal::WriteJsonString(output, span.type_name);
+                output << ",\"lifetime\":\"" << internal::ToString(span.lifetime) << "\"}}";
+            }
+        }
+        output << "\n]}\n";
+    }
+}